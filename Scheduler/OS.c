@@ -17,281 +17,3086 @@
  */ 
 
 #include "OS.h"
+#include "OS_Port.h"
 
-static OS_struct    task_array[OS_MAX_TASK_NUM];    /**< Variables and information for every single task. */
-static uint8_t      task_count = 0u;                /**< Tail index of the task array, not necessarily to be number of tasks, some task may be dropped. */
-static uint32_t     os_time = 0;                    /**< os clock variable, increases every 1ms */
+#define OS_READY_WORDS      (((uint32_t)OS_MAX_TASK_NUM + 31u) / 32u)   /**< Number of 32 bit words in the ready bitmap. */
+#define OS_NO_POS           ((OS_pos)(OS_MAX_TASK_NUM + 1u))            /**< Invalid task/heap position. */
+#define OS_USE_TIMESTAMP    (OS_CONFIG_PROFILING || OS_CONFIG_BUDGET)   /**< Task executions are timestamped. */
+#define OS_HANDLE_POS(handle)   ((handle) & 0x0FFFu)                    /**< Task position of a handle. */
+#define OS_HANDLE_CORE(handle)  (((handle) >> 12) & 0x0Fu)              /**< Scheduler instance of a handle, the core for the instances of the cores. */
+
+#if OS_CONFIG_TIME_BITS == 16
+#define OS_TASK_TIME_DIFF(a, b) ((int32_t)(int16_t)(uint16_t)((uint32_t)(a) - (uint32_t)(b)))  /**< OS_TIME_DIFF() of times stored in tasks. */
+#else
+#define OS_TASK_TIME_DIFF(a, b) OS_TIME_DIFF(a, b)                                              /**< OS_TIME_DIFF() of times stored in tasks. */
+#endif
+
+#if OS_CONFIG_STATIC_TASKS
+/**
+ * Build time part of a static task, kept in flash.
+ */
+typedef struct
+{
+    fncPtr      function;               /**< This is the task that gets called periodically. */
+    void *      data_ptr;               /**< Data to pass task function. */
+    uint32_t    task_period;            /**< Default period of the task. */
+    uint32_t    defer_time;             /**< Delay time for the first execution of the task. */
+    uint8_t     state;                  /**< Default state of the task. */
+} OS_task_desc;
+
+#define OS_TASK_DESC(name, function, period, state, data_ptr, defer_time) {function, data_ptr, period, defer_time, state},
+#define OS_TASK_CHECK(name, function, period, state, data_ptr, defer_time) \
+    typedef char OS_task_check_##name[(((period) >= OS_MIN_TIME) && ((period) <= OS_MAX_TIME) && (((defer_time) <= OS_MAX_TIME) || ((defer_time) == OS_DEFER_AUTO)) && ((state) != STOPPED)) ? 1 : -1];
+
+OS_TASK_TABLE(OS_TASK_CHECK)    /* a task with period or defer time out of limits, or STOPPED default state fails here */
+typedef char OS_task_check_count[(OS_STATIC_TASK_NUM < 0xFF) ? 1 : -1];
+
+static const OS_task_desc task_table[OS_MAX_TASK_NUM] = { OS_TASK_TABLE(OS_TASK_DESC) }; /**< Build time part of every single task. */
+
+#define OS_TASK_FUNCTION(sc, task)  (task_table[task].function)
+#define OS_TASK_DATA(sc, task)      (task_table[task].data_ptr)
+#define OS_TASK_END(sc)             OS_MAX_TASK_NUM     /**< Positions below this may hold a task. */
+#else
+#define OS_TASK_END(sc)             ((sc)->task_tail)   /**< Positions below this may hold a task. */
+#endif
+
+#if OS_CONFIG_FIXED_RATE
+#define OS_TASK_TIMED(sc, task)     (OS_TASK(sc, task).timed)   /**< Function of the task is a fncPtrTimed. */
+#else
+#define OS_TASK_TIMED(sc, task)     0u
+#endif
+
+#if OS_CONFIG_TASK_ARENA
+#define OS_ARENA_BLOCKS     (((uint32_t)OS_MAX_TASK_NUM + OS_CONFIG_ARENA_BLOCK - 1u) / OS_CONFIG_ARENA_BLOCK) /**< Number of storage blocks up to the position limit. */
+#define OS_SLOT(sc, task)   ((sc)->arena_block[(uint32_t)(task) / OS_CONFIG_ARENA_BLOCK][(uint32_t)(task) % OS_CONFIG_ARENA_BLOCK]) /**< Storage of a position. */
+
+/* Storage of every position is a slot of an arena block, list and heap entries at a position are kept in its slot. */
+#define OS_TASK(sc, pos)            (OS_SLOT(sc, pos).task)
+#define OS_TASK_FUNCTION(sc, task)  (OS_SLOT(sc, task).function)
+#define OS_TASK_DATA(sc, task)      (OS_SLOT(sc, task).data_ptr)
+#define OS_LIVE_LIST(sc, pos)       (OS_SLOT(sc, pos).live_entry)
+#define OS_DEADLINE_HEAP(sc, pos)   (OS_SLOT(sc, pos).heap_entry)
+#define OS_READY_HEAP(sc, pos)      (OS_SLOT(sc, pos).ready_entry)
+#define OS_PROFILE(sc, task)        (OS_SLOT(sc, task).profile)
+#else
+#define OS_TASK(sc, task)           ((sc)->task_array[task])
+#if !OS_CONFIG_STATIC_TASKS
+#define OS_TASK_FUNCTION(sc, task)  ((sc)->task_function[task])
+#define OS_TASK_DATA(sc, task)      ((sc)->task_data[task])
+#endif
+#define OS_LIVE_LIST(sc, pos)       ((sc)->live_list[pos])
+#define OS_DEADLINE_HEAP(sc, pos)   ((sc)->deadline_heap[pos])
+#define OS_READY_HEAP(sc, pos)      ((sc)->ready_heap[pos])
+#define OS_PROFILE(sc, task)        ((sc)->task_profile[task])
+#endif
+
+#if OS_CONFIG_PROFILING
+/**
+ * Scheduler wide profiling data.
+ */
+typedef struct
+{
+    uint32_t    passes;                 /**< Number of execution passes. */
+    uint32_t    activations;            /**< Number of task executions. */
+    uint32_t    missed_deadlines;       /**< Sum of missed deadlines. */
+    uint32_t    ticks;                  /**< Number of timer calls. */
+    uint32_t    tick_max;               /**< Maximal cost of a timer call. */
+    uint64_t    tick_total;             /**< Sum of timer call costs. */
+    uint64_t    busy_total;             /**< Time spent in tasks. */
+    uint64_t    span_total;             /**< Time measured between execution passes. */
+    uint32_t    last_pass;              /**< Timestamp of the previous execution pass. */
+    uint32_t    dispatch_max;           /**< Maximal cost of an execution pass outside the tasks. */
+    uint64_t    dispatch_total;         /**< Sum of execution pass costs outside the tasks. */
+} OS_sched_profile;
+#endif
+
+#if OS_CONFIG_CORES > 1
+/**
+ * Request from another core to register a task, sent through the mailbox.
+ */
+typedef struct
+{
+    fncPtr      function;               /**< Function of the task. */
+    void *      data_ptr;               /**< Data to pass task function. */
+    uint32_t    task_period;            /**< Period of the task. */
+    uint32_t    defer_time;             /**< Delay time for the first execution of the task. */
+    uint8_t     state;                  /**< State of the task. */
+    uint8_t     priority;               /**< Priority of the task. */
+    uint8_t     overrun;                /**< Overrun policy of the task. */
+    uint8_t     burst_limit;            /**< Catch-up burst limit of the task. */
+    uint8_t     timed;                  /**< Function of the task is a fncPtrTimed. */
+} OS_mail;
+
+/**
+ * Single producer single consumer ring from one core to another, lock-free.
+ */
+typedef struct
+{
+    OS_mail     mail[OS_CONFIG_MAILBOX_SIZE]; /**< Requests in order. */
+    volatile uint32_t head;             /**< Number of requests sent, written only by the sender core. */
+    volatile uint32_t tail;             /**< Number of requests taken, written only by the receiver core. */
+    volatile uint32_t lost;             /**< Number of requests dropped as the task array was full, written only by the receiver core. */
+} OS_mailbox;
+#endif
+
+/**
+ * Scheduler of a core, it is owned by the main loop of that core.
+ */
+typedef struct
+{
+#if OS_CONFIG_TASK_ARENA
+    OS_task_slot *arena_block[OS_ARENA_BLOCKS]; /**< Storage blocks of OS_CONFIG_ARENA_BLOCK positions each, in position order. */
+    OS_pos      task_capacity;                  /**< Number of positions with storage. */
+    OS_arenaHook arena_hook;                    /**< User hook to add storage when every position is used. */
+#else
+    OS_struct   task_array[OS_MAX_TASK_NUM];    /**< Variables and information for every single task. */
+#endif
+#if OS_CONFIG_STATIC_TASKS
+    bool        table_started;                  /**< Default states of the table are applied. */
+#else
+#if !OS_CONFIG_TASK_ARENA
+    fncPtr      task_function[OS_MAX_TASK_NUM]; /**< Function of every single task, NULL if position is dropped. */
+    void *      task_data[OS_MAX_TASK_NUM];     /**< Data to pass task function of every single task. */
+#endif
+    OS_pos      task_count;                     /**< Number of live tasks, some positions below the tail may be dropped. */
+    OS_pos      task_tail;                      /**< Tail index of the task array, positions from here on were never used. */
+#if !OS_CONFIG_TASK_ARENA
+    OS_pos      live_list[OS_MAX_TASK_NUM];     /**< Positions of live tasks in first task_count entries, then dropped positions up to the tail. */
+#endif
+#endif
+    volatile uint32_t os_time;                  /**< os clock variable, increases every tick (OS_CONFIG_TICK_US) */
+#if !OS_CONFIG_TASK_ARENA
+    OS_pos      deadline_heap[OS_MAX_TASK_NUM]; /**< Binary min-heap of BLOCKED task positions, keyed on execute_time. */
+#endif
+    OS_pos      heap_size;                      /**< Number of tasks in the deadline heap. */
+#if OS_CONFIG_EDF
+#if !OS_CONFIG_TASK_ARENA
+    OS_pos      ready_heap[OS_MAX_TASK_NUM];    /**< Binary min-heap of READY task positions, keyed on deadline. */
+#endif
+    OS_pos      ready_size;                     /**< Number of tasks in the ready heap. */
+#endif
+    OS_pos      running;                        /**< Position of the task being executed plus 1, 0 if no task is executed. */
+    OS_pos      dispatch_from;                  /**< Position a bounded execution pass starts its search from. */
+    uint32_t    ready_map[OS_CONFIG_PRIORITY_LEVELS][OS_READY_WORDS];  /**< Bitmaps of READY task positions per priority, bit i is task_array[i]. */
+    uint32_t    ready_prio;                     /**< Bitmap of priorities which have READY tasks. */
+    volatile uint32_t isr_ready_map[OS_READY_WORDS]; /**< READY requests from interrupts and other cores, set atomically, moved to READY state by main loop. */
+    volatile uint32_t post_map[OS_READY_WORDS]; /**< Posted tasks, set atomically, moved to READY state by main loop. */
+    OS_idleHook idle_hook;                      /**< User hook to sleep when no task is READY. */
+#if OS_CONFIG_TICKLESS
+    OS_alarmHook alarm_hook;                    /**< User hook to program the one-shot wake-up timer. */
+    uint32_t    alarm_deadline;                 /**< Last deadline reported to the alarm hook. */
+#endif
+#if OS_CONFIG_BUDGET
+    OS_watchdogHook watchdog_hook;              /**< User hook to feed the watchdog. */
+    uint32_t    pass_budget;                    /**< Budget of a whole execution pass, 0 for no budget. */
+#endif
+#if OS_CONFIG_PROFILING
+#if !OS_CONFIG_TASK_ARENA
+    OS_profile  task_profile[OS_MAX_TASK_NUM];  /**< Profiling data of every single task. */
+#endif
+    OS_sched_profile sched_profile;             /**< Scheduler wide profiling data. */
+#endif
+#if OS_CONFIG_CHAINS
+    uint32_t    chain_next[OS_MAX_TASK_NUM][OS_READY_WORDS]; /**< Successors of every single task. */
+    uint32_t    chain_prev[OS_MAX_TASK_NUM][OS_READY_WORDS]; /**< Predecessors of every single task. */
+    uint32_t    chain_done[OS_MAX_TASK_NUM][OS_READY_WORDS]; /**< Predecessors completed since last trigger of every single task. */
+#endif
+#if OS_CONFIG_SNAPSHOT
+    uint32_t    snapshot_time;                  /**< os time of the last refresh of the snapshot mirror. */
+#endif
+#if OS_CONFIG_TASK_GROUPS
+    uint32_t    group_suspended;                /**< Suspended groups. */
+    uint32_t    group_scaled;                   /**< Groups with a period scale factor above 1. */
+    uint16_t    group_scale[OS_CONFIG_TASK_GROUPS]; /**< Period scale factor of every single group. */
+    uint32_t    parked_map[OS_READY_WORDS];     /**< Tasks put into SUSPENDED state because a group of theirs is suspended, resumed with the group. */
+#endif
+#if OS_CONFIG_SOFT_TIMERS
+    OS_timer    *timer_wheel[OS_CONFIG_TIMER_WHEEL_SIZE]; /**< Started timers, slot of a timer is its expire time modulo wheel size. */
+    uint32_t    timer_time;                     /**< os time up to which expired timers are called. */
+#endif
+#if OS_CONFIG_TRACE
+    uint32_t    trace_buffer[OS_CONFIG_TRACE_SIZE]; /**< Ring of trace records. */
+    uint32_t    trace_head;                     /**< Records written, free running. */
+    uint32_t    trace_tail;                     /**< Records read, free running. */
+    uint32_t    trace_stamp;                    /**< Timestamp of the last written record. */
+    uint32_t    trace_lost;                     /**< Records dropped since the last written record. */
+    bool        trace_paused;                   /**< No record is written. */
+#endif
+#if OS_CONFIG_CORES > 1
+    OS_mailbox  mailbox[OS_CONFIG_CORES];       /**< Requests from other cores, one ring per sender core. */
+#endif
+#if OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES
+    uint8_t     core;                           /**< Core the instance is bound to, instances of the cores are bound to their core. */
+    bool        bound;                          /**< Instance is bound by OS_SchedulerInit(). */
+#endif
+} OS_sched;
+
+static OS_sched     os_sched[OS_CONFIG_SCHEDULERS]; /**< Scheduler instances, the first ones are the schedulers of the cores, all zero at start-up. */
+static OS_deadlineHook deadline_hook = NULL;        /**< User hook to report missed activations. */
+#if OS_CONFIG_SNAPSHOT
+OS_snapshot         os_snapshot[OS_CONFIG_SCHEDULERS] OS_CONFIG_SNAPSHOT_ATTRIBUTE; /**< Mirror of every scheduler instance, written only by the main loop of its core. */
+#endif
+#if OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES
+static OS_sched     *os_current[OS_CONFIG_CORES];   /**< Instance selected or being executed by the main loop of every single core, NULL for the instance of the core. */
+#endif
+
+/**
+ * Return scheduler of the calling core, the selected instance in the main loop if there are several instances
+ */
+static OS_sched *OS_SchedSelf(void){
+#if OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES
+    OS_sched *sc = os_current[OS_PortCoreId()];
+    if((sc != NULL) && !OS_PortInIsr()){ //interrupts act on the instance of the core
+        return sc;
+    }
+#endif
+    return &os_sched[OS_PortCoreId()];
+}
+
+/**
+ * Return core a scheduler instance is bound to
+ */
+static uint8_t OS_SchedOwner(const OS_sched *sc){
+#if OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES
+    if(sc >= &os_sched[OS_CONFIG_CORES]){
+        return sc->core;
+    }
+#endif
+    return (uint8_t)(sc - os_sched);
+}
+
+#if !OS_CONFIG_STATIC_TASKS
+/**
+ * Return index of a scheduler instance, the core index for the instances of the cores
+ */
+static uint8_t OS_SchedCore(const OS_sched *sc){
+    return (uint8_t)(sc - os_sched);
+}
+#endif
+
+#if OS_CONFIG_CORES > 1
+#define OS_SCHED_WAKE()     OS_PortSignalEvent()    /**< Wake up other cores sleeping in idle after a request. */
+#else
+#define OS_SCHED_WAKE()
+#endif
+
+static OS_timestampHook timestamp_hook = NULL;      /**< User timestamp source, DWT cycle counter if NULL. */
+static bool         cycle_counter_on = false;       /**< DWT cycle counter is enabled. */
+
+/**
+ * Return current timestamp from the user hook or the DWT cycle counter
+ */
+static uint32_t OS_Timestamp(void){
+    if(timestamp_hook != NULL){
+        return timestamp_hook();
+    }
+    if(!cycle_counter_on){ //enable on first use
+        OS_PortCycleCounterInit();
+        cycle_counter_on = true;
+    }
+    return OS_PortCycleCounter();
+}
+
+#if OS_CONFIG_BUDGET
+static OS_budgetHook budget_hook = NULL;            /**< User hook to report budget overruns. */
+#endif
+
+#if OS_CONFIG_TRACE
+#define OS_TRACE_DELTA_MAX  0x000FFFFFu     /**< Largest delta in a record, larger ones are preceded by an OS_TRACE_EXT record. */
+
+/**
+ * Write a trace record, interrupts are masked for the few instructions as interrupts trace posts too
+ * If buffer is full the record is dropped and counted, an OS_TRACE_LOST record precedes the next one written
+ */
+static void OS_TraceRecord(OS_sched *sc, OS_trace_event event, OS_pos task){
+    uint32_t primask = OS_PortIrqSave();
+    if(!sc->trace_paused){
+        uint32_t now = OS_Timestamp();
+        uint32_t delta = now - sc->trace_stamp;
+        uint32_t need = 1u + ((sc->trace_lost != 0u) ? 1u : 0u) + ((delta > OS_TRACE_DELTA_MAX) ? 1u : 0u);
+        if((sc->trace_head - sc->trace_tail) + need > OS_CONFIG_TRACE_SIZE){
+            sc->trace_lost++;
+        }else{
+            if(delta > OS_TRACE_DELTA_MAX){
+                sc->trace_buffer[sc->trace_head++ % OS_CONFIG_TRACE_SIZE] = ((delta >> 20) << 4) | (uint32_t)OS_TRACE_EXT;
+                delta &= OS_TRACE_DELTA_MAX;
+            }
+            if(sc->trace_lost != 0u){ //gap is marked, its delta covers the dropped records
+                uint32_t lost = (sc->trace_lost > 0xFFu) ? 0xFFu : sc->trace_lost;
+                sc->trace_buffer[sc->trace_head++ % OS_CONFIG_TRACE_SIZE] = (delta << 12) | (lost << 4) | (uint32_t)OS_TRACE_LOST;
+                sc->trace_lost = 0u;
+                delta = 0u;
+            }
+#if !OS_CONFIG_STATIC_TASKS && (OS_CONFIG_MAX_TASKS > 254)
+            uint32_t field = (task > 0xFFu) ? 0xFFu : (uint32_t)task; //positions from 255 on share the last value
+#else
+            uint32_t field = (uint32_t)task; //8 bit positions fit the field
+#endif
+            sc->trace_buffer[sc->trace_head++ % OS_CONFIG_TRACE_SIZE] = (delta << 12) | (field << 4) | (uint32_t)event;
+            sc->trace_stamp = now;
+        }
+    }
+    OS_PortIrqRestore(primask);
+}
+#define OS_TRACE(sc, event, task)   OS_TraceRecord(sc, event, task)
+#else
+#define OS_TRACE(sc, event, task)
+#endif
+
+#if OS_CONFIG_PROFILING
+/**
+ * Clear profiling data of a task
+ */
+static void OS_ProfileClear(OS_sched *sc, OS_pos task){
+    static const OS_profile cleared = {0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u};
+    OS_PROFILE(sc, task) = cleared;
+}
+
+/**
+ * Record the start of a task execution and release-to-start latency
+ */
+static void OS_ProfileStart(OS_sched *sc, OS_pos task){
+    OS_profile *prof = &OS_PROFILE(sc, task);
+    uint32_t latency = sc->os_time - prof->release_time;
+    if(latency > prof->latency_max){
+        prof->latency_max = latency;
+    }
+    prof->latency_total += latency;
+}
+
+/**
+ * Record the end of a task execution
+ */
+static void OS_ProfileEnd(OS_sched *sc, OS_pos task, uint32_t run_time){
+    OS_profile *prof = &OS_PROFILE(sc, task);
+    if((prof->activations == 0u) || (run_time < prof->run_min)){
+        prof->run_min = run_time;
+    }
+    if(run_time > prof->run_max){
+        prof->run_max = run_time;
+    }
+    prof->run_total += run_time;
+    prof->activations++;
+    sc->sched_profile.activations++;
+    sc->sched_profile.busy_total += run_time;
+}
+
+/**
+ * Update scheduler cost of an execution pass, time spent in release, dispatch and hooks
+ */
+static void OS_ProfilePass(OS_sched *sc, uint32_t cost){
+    if(cost > sc->sched_profile.dispatch_max){
+        sc->sched_profile.dispatch_max = cost;
+    }
+    sc->sched_profile.dispatch_total += cost;
+}
+
+/**
+ * Fill statistics of the task at given position
+ */
+static void OS_ProfileGet(OS_sched *sc, OS_pos task, OS_task_stats *stats){
+    const OS_profile *prof = &OS_PROFILE(sc, task);
+    stats->activations = prof->activations;
+    stats->run_min = prof->run_min;
+    stats->run_max = prof->run_max;
+    stats->run_avg = (prof->activations != 0u) ? (uint32_t)(prof->run_total / prof->activations) : 0u;
+    stats->latency_max = prof->latency_max;
+    stats->latency_avg = (prof->activations != 0u) ? (uint32_t)(prof->latency_total / prof->activations) : 0u;
+    stats->missed_deadlines = prof->missed_deadlines;
+}
+
+/**
+ * Fill scheduler wide statistics
+ */
+static void OS_ProfileSchedGet(OS_sched *sc, OS_sched_stats *stats){
+    stats->passes = sc->sched_profile.passes;
+    stats->activations = sc->sched_profile.activations;
+    stats->missed_deadlines = sc->sched_profile.missed_deadlines;
+    stats->ticks = sc->sched_profile.ticks;
+    stats->tick_isr_max = sc->sched_profile.tick_max;
+    stats->tick_isr_avg = (sc->sched_profile.ticks != 0u) ? (uint32_t)(sc->sched_profile.tick_total / sc->sched_profile.ticks) : 0u;
+    stats->dispatch_max = sc->sched_profile.dispatch_max;
+    stats->dispatch_avg = (sc->sched_profile.passes != 0u) ? (uint32_t)(sc->sched_profile.dispatch_total / sc->sched_profile.passes) : 0u;
+    if((sc->sched_profile.span_total == 0u) || (sc->sched_profile.busy_total >= sc->sched_profile.span_total)){
+        stats->idle_permille = (sc->sched_profile.span_total == 0u) ? 1000u : 0u;
+    }else{
+        stats->idle_permille = (uint32_t)(1000u - ((sc->sched_profile.busy_total * 1000u) / sc->sched_profile.span_total));
+    }
+}
+#endif
+
+/**
+ * Find and return task position if task in list
+ * If task is not in list, returns and invalid position
+ */
+static OS_pos OS_TaskFind(OS_sched *sc, fncPtr function){
+#if OS_CONFIG_STATIC_TASKS
+    (void)sc;
+    for(OS_pos i = 0; i < OS_MAX_TASK_NUM; i++){ //table is read from flash
+        if(task_table[i].function == function){
+            return i;
+        }
+    }
+#else
+    for(OS_pos i = 0; i < sc->task_count; i++){ //only live tasks are visited
+        if(OS_TASK_FUNCTION(sc, OS_LIVE_LIST(sc, i)) == function){
+            return OS_LIVE_LIST(sc, i);
+        }
+    }
+#endif
+    return OS_NO_POS; //task in not in array, return an invalid position
+}
+
+#if !OS_CONFIG_STATIC_TASKS
+/**
+ * Find and return a proper position to insert task to the list, there SHALL be room for a new task
+ * If there is empty position which is place of previously STOPPED (dropped) task, return the last dropped position
+ * (dropped positions follow the live ones in live list)
+ * Otherwise, return the tail of the task list
+ * The position is added to the list of live tasks
+ */
+static OS_pos OS_TaskInsertPosition(OS_sched *sc){
+	OS_pos i;
+    if(sc->task_count < sc->task_tail){ //reuse last dropped position
+        i = OS_LIVE_LIST(sc, sc->task_count);
+    }else{ //no empty position till to the last task, add to the end of list
+        i = sc->task_tail;
+        OS_LIVE_LIST(sc, i) = i;
+        sc->task_tail++;
+    }
+    if(OS_TASK(sc, i).generation == 0u){ //never used position, so that a handle is never OS_HANDLE_INVALID
+        OS_TASK(sc, i).generation = 1u;
+    }
+    OS_TASK(sc, i).live_pos = sc->task_count;
+    sc->task_count++;
+    return i;
+}
+
+/**
+ * Return true if a new task can be inserted, the arena hook is asked for storage first when every position with storage is used
+ */
+static bool OS_TaskHasRoom(OS_sched *sc){
+#if OS_CONFIG_TASK_ARENA
+    if((sc->task_count == sc->task_tail) && (sc->task_tail >= sc->task_capacity) && (sc->arena_hook != NULL)){
+        sc->arena_hook();
+    }
+    return (sc->task_count < sc->task_tail) || (sc->task_tail < sc->task_capacity);
+#else
+    return sc->task_count < OS_MAX_TASK_NUM;
+#endif
+}
+#endif
+
+/**
+ * Build handle of the task at given position
+ */
+static OS_handle OS_TaskHandle(OS_sched *sc, OS_pos position){
+#if OS_CONFIG_STATIC_TASKS
+    (void)sc;
+    return ((OS_handle)1u << 16) | position; //static tasks are never dropped, see OS_TASK_HANDLE()
+#else
+    return ((OS_handle)OS_TASK(sc, position).generation << 16) | ((OS_handle)OS_SchedCore(sc) << 12) | position;
+#endif
+}
+
+/**
+ * Find and return task position of a handle, scheduler instance of the task is written to *sc
+ * If handle is stale (task is dropped) or invalid, returns an invalid position
+ */
+static OS_pos OS_HandleFind(OS_handle handle, OS_sched **sc){
+    uint32_t position = OS_HANDLE_POS(handle);
+    uint32_t core = OS_HANDLE_CORE(handle);
+    if(core >= OS_CONFIG_SCHEDULERS){
+        return OS_NO_POS;
+    }
+    *sc = &os_sched[core];
+#if OS_CONFIG_STATIC_TASKS
+    if((position < OS_MAX_TASK_NUM) && ((handle >> 16) == 1u)){
+        return (OS_pos)position;
+    }
+#else
+    if((position < (*sc)->task_tail) && (OS_TASK_FUNCTION(*sc, position) != NULL) && (OS_TASK(*sc, position).generation == (uint16_t)(handle >> 16))){
+        return (OS_pos)position;
+    }
+#endif
+    return OS_NO_POS;
+}
+
+/**
+ * Find task of a handle to be changed by the caller, scheduler and position of the task are written to *sc and *task
+ * Tasks are owned by the main loop of their core, so interrupt handlers and other cores can not change them
+ * Instances of the same core share the main loop, so a task of any of them can be changed there
+ */
+static OS_feedback OS_HandleOwned(OS_handle handle, OS_sched **sc, OS_pos *task){
+    if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }
+    *task = OS_HandleFind(handle, sc);
+    if(*task >= OS_MAX_TASK_NUM){
+        return NOK_INVALID_HANDLE;
+    }else if(OS_SchedOwner(*sc) != OS_PortCoreId()){
+        return NOK_OTHER_CORE;
+    }else{
+        return OK;
+    }
+}
+
+/**
+ * Heap order of two tasks, earlier execute_time first, lower position first on equal times
+ * Times are compared by wrap-safe difference, so the order holds across os time wrap
+ */
+static bool OS_HeapLess(OS_sched *sc, OS_pos a, OS_pos b){
+    if(OS_TASK(sc, a).execute_time != OS_TASK(sc, b).execute_time){
+        return OS_TASK_TIME_DIFF(OS_TASK(sc, a).execute_time, OS_TASK(sc, b).execute_time) < 0;
+    }
+    return a < b;
+}
+
+/**
+ * Place task to given heap position and record it in the task
+ */
+static void OS_HeapPlace(OS_sched *sc, OS_pos pos, OS_pos task){
+    OS_DEADLINE_HEAP(sc, pos) = task;
+    OS_TASK(sc, task).heap_pos = pos;
+}
+
+/**
+ * Move the task at given heap position towards the root until heap order holds
+ */
+static void OS_HeapSiftUp(OS_sched *sc, OS_pos pos){
+    OS_pos task = OS_DEADLINE_HEAP(sc, pos);
+    while((pos > 0u) && (pos < OS_MAX_TASK_NUM)){ //bound as in OS_HeapSiftDown()
+        OS_pos parent = (OS_pos)((pos - 1u) / 2u);
+        if(!OS_HeapLess(sc, task, OS_DEADLINE_HEAP(sc, parent))){
+            break;
+        }
+        OS_HeapPlace(sc, pos, OS_DEADLINE_HEAP(sc, parent));
+        pos = parent;
+    }
+    OS_HeapPlace(sc, pos, task);
+}
+
+/**
+ * Move the task at given heap position towards the leaves until heap order holds
+ */
+static void OS_HeapSiftDown(OS_sched *sc, OS_pos pos){
+    OS_pos task = OS_DEADLINE_HEAP(sc, pos);
+    for(;;){
+        uint32_t child = 2u * pos + 1u; //not narrowed, it exceeds the position type for large task arrays
+        if((child >= sc->heap_size) || (child >= OS_MAX_TASK_NUM)){ //heap size never exceeds OS_MAX_TASK_NUM, the bound keeps the index provably in range
+            break;
+        }
+        if(((child + 1u) < sc->heap_size) && ((child + 1u) < OS_MAX_TASK_NUM) && OS_HeapLess(sc, OS_DEADLINE_HEAP(sc, child + 1u), OS_DEADLINE_HEAP(sc, child))){
+            child++;
+        }
+        if(!OS_HeapLess(sc, OS_DEADLINE_HEAP(sc, child), task)){
+            break;
+        }
+        OS_HeapPlace(sc, pos, OS_DEADLINE_HEAP(sc, child));
+        pos = (OS_pos)child;
+    }
+    OS_HeapPlace(sc, pos, task);
+}
+
+/**
+ * Insert task to deadline heap
+ */
+static void OS_HeapPush(OS_sched *sc, OS_pos task){
+    OS_HeapPlace(sc, sc->heap_size, task);
+    sc->heap_size++;
+    OS_HeapSiftUp(sc, (OS_pos)(sc->heap_size - 1u));
+}
+
+/**
+ * Remove task from deadline heap, task SHALL be in the heap
+ */
+static void OS_HeapRemove(OS_sched *sc, OS_pos task){
+    OS_pos pos = OS_TASK(sc, task).heap_pos;
+    sc->heap_size--;
+    if(pos != sc->heap_size){ //fill the hole with the last element and restore order
+        OS_HeapPlace(sc, pos, OS_DEADLINE_HEAP(sc, sc->heap_size));
+        if((pos > 0u) && OS_HeapLess(sc, OS_DEADLINE_HEAP(sc, pos), OS_DEADLINE_HEAP(sc, (pos - 1u) / 2u))){
+            OS_HeapSiftUp(sc, pos);
+        }else{
+            OS_HeapSiftDown(sc, pos);
+        }
+    }
+    OS_TASK(sc, task).heap_pos = OS_NO_POS;
+}
+
+#if OS_CONFIG_EDF
+/**
+ * Ready heap order of two tasks, earlier deadline first, lower position first on equal deadlines
+ */
+static bool OS_EdfLess(OS_sched *sc, OS_pos a, OS_pos b){
+    if(OS_TASK(sc, a).deadline != OS_TASK(sc, b).deadline){
+        return OS_TASK_TIME_DIFF(OS_TASK(sc, a).deadline, OS_TASK(sc, b).deadline) < 0;
+    }
+    return a < b;
+}
+
+/**
+ * Place task to given ready heap position, heap position of the task is shared with the deadline heap as READY tasks are not BLOCKED
+ */
+static void OS_EdfPlace(OS_sched *sc, OS_pos pos, OS_pos task){
+    OS_READY_HEAP(sc, pos) = task;
+    OS_TASK(sc, task).heap_pos = pos;
+}
+
+/**
+ * Move the task at given ready heap position towards the root until heap order holds
+ */
+static void OS_EdfSiftUp(OS_sched *sc, OS_pos pos){
+    OS_pos task = OS_READY_HEAP(sc, pos);
+    while((pos > 0u) && (pos < OS_MAX_TASK_NUM)){ //bound as in OS_HeapSiftDown()
+        OS_pos parent = (OS_pos)((pos - 1u) / 2u);
+        if(!OS_EdfLess(sc, task, OS_READY_HEAP(sc, parent))){
+            break;
+        }
+        OS_EdfPlace(sc, pos, OS_READY_HEAP(sc, parent));
+        pos = parent;
+    }
+    OS_EdfPlace(sc, pos, task);
+}
+
+/**
+ * Move the task at given ready heap position towards the leaves until heap order holds
+ */
+static void OS_EdfSiftDown(OS_sched *sc, OS_pos pos){
+    OS_pos task = OS_READY_HEAP(sc, pos);
+    for(;;){
+        uint32_t child = 2u * pos + 1u;
+        if((child >= sc->ready_size) || (child >= OS_MAX_TASK_NUM)){ //bound as in OS_HeapSiftDown()
+            break;
+        }
+        if(((child + 1u) < sc->ready_size) && ((child + 1u) < OS_MAX_TASK_NUM) && OS_EdfLess(sc, OS_READY_HEAP(sc, child + 1u), OS_READY_HEAP(sc, child))){
+            child++;
+        }
+        if(!OS_EdfLess(sc, OS_READY_HEAP(sc, child), task)){
+            break;
+        }
+        OS_EdfPlace(sc, pos, OS_READY_HEAP(sc, child));
+        pos = (OS_pos)child;
+    }
+    OS_EdfPlace(sc, pos, task);
+}
+
+/**
+ * Remove task from ready heap, task SHALL be in the heap
+ */
+static void OS_EdfRemove(OS_sched *sc, OS_pos task){
+    OS_pos pos = OS_TASK(sc, task).heap_pos;
+    sc->ready_size--;
+    if(pos != sc->ready_size){ //fill the hole with the last element and restore order
+        OS_EdfPlace(sc, pos, OS_READY_HEAP(sc, sc->ready_size));
+        if((pos > 0u) && OS_EdfLess(sc, OS_READY_HEAP(sc, pos), OS_READY_HEAP(sc, (pos - 1u) / 2u))){
+            OS_EdfSiftUp(sc, pos);
+        }else{
+            OS_EdfSiftDown(sc, pos);
+        }
+    }
+    OS_TASK(sc, task).heap_pos = OS_NO_POS;
+}
+
+/**
+ * Return total utilisation of the tasks which are not STOPPED in 1/65536 units, with given wcet and period for the task at given position
+ */
+static uint64_t OS_EdfUtilisation(OS_sched *sc, OS_pos task, uint32_t wcet, uint32_t period){
+    uint64_t total = 0u;
+    for(OS_pos t = 0u; t < OS_TASK_END(sc); t++){
+        uint32_t c = (t == task) ? wcet : OS_TASK(sc, t).wcet;
+        uint32_t p = (t == task) ? period : (uint32_t)OS_TASK(sc, t).task_period;
+        if((c != 0u) && (p != 0u) && ((t == task) || (OS_TASK(sc, t).state != STOPPED))){
+            total += ((uint64_t)c << 16) / ((uint64_t)p * OS_CONFIG_TICK_US);
+        }
+    }
+    return total;
+}
+#endif
+
+/**
+ * Mark task as READY in ready bitmap of its priority
+ * With EDF it is also inserted to the ready heap, its deadline SHALL be set before
+ */
+static void OS_ReadySet(OS_sched *sc, OS_pos task){
+    uint8_t prio = OS_TASK(sc, task).priority;
+#if OS_CONFIG_EDF
+    if((sc->ready_map[prio][task / 32u] & (1u << (task % 32u))) == 0u){
+        OS_EdfPlace(sc, sc->ready_size, task);
+        sc->ready_size++;
+        OS_EdfSiftUp(sc, (OS_pos)(sc->ready_size - 1u));
+    }
+#endif
+    sc->ready_map[prio][task / 32u] |= (1u << (task % 32u));
+    sc->ready_prio |= (1u << prio);
+}
+
+/**
+ * Clear task from ready bitmap of its priority
+ */
+static void OS_ReadyClear(OS_sched *sc, OS_pos task){
+    uint8_t prio = OS_TASK(sc, task).priority;
+#if OS_CONFIG_EDF
+    if((sc->ready_map[prio][task / 32u] & (1u << (task % 32u))) != 0u){
+        OS_EdfRemove(sc, task);
+    }
+#endif
+    sc->ready_map[prio][task / 32u] &= ~(1u << (task % 32u));
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        if(sc->ready_map[prio][w] != 0u){
+            return;
+        }
+    }
+    sc->ready_prio &= ~(1u << prio); //no READY task left in this priority
+}
+
+/**
+ * Return true if task is marked in ready bitmap
+ */
+static bool OS_ReadyIsSet(OS_sched *sc, OS_pos task){
+    return (sc->ready_map[OS_TASK(sc, task).priority][task / 32u] & (1u << (task % 32u))) != 0u;
+}
+
+/**
+ * Return lowest READY task position of the highest READY priority (earliest deadline with EDF), OS_NO_POS if no task is READY
+ */
+static OS_pos OS_ReadyNext(OS_sched *sc){
+#if OS_CONFIG_EDF
+    return (sc->ready_size != 0u) ? OS_READY_HEAP(sc, 0) : OS_NO_POS; //earliest deadline
+#else
+    if(sc->ready_prio == 0u){
+        return OS_NO_POS;
+    }
+    uint8_t prio = (uint8_t)(31u - OS_PortClz(sc->ready_prio));
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        if(sc->ready_map[prio][w] != 0u){
+            return (OS_pos)(w * 32u + OS_PortCtz(sc->ready_map[prio][w]));
+        }
+    }
+    return OS_NO_POS;
+#endif
+}
+
+/**
+ * Return first READY task position of the highest READY priority at or after from, wrapping to the start, OS_NO_POS if no task is READY
+ */
+static OS_pos OS_ReadyNextFrom(OS_sched *sc, OS_pos from){
+#if OS_CONFIG_EDF
+    (void)from; //deadlines order the tasks, none starves
+    return OS_ReadyNext(sc);
+#else
+    if(sc->ready_prio == 0u){
+        return OS_NO_POS;
+    }
+    uint8_t prio = (uint8_t)(31u - OS_PortClz(sc->ready_prio));
+    uint8_t w = (uint8_t)(from / 32u);
+    uint32_t bits = sc->ready_map[prio][w] & (0xFFFFFFFFu << (from % 32u));
+    if(bits != 0u){
+        return (OS_pos)(w * 32u + OS_PortCtz(bits));
+    }
+    for(uint8_t k = 1u; k <= OS_READY_WORDS; k++){ //following words, then the start of this word
+        uint8_t v = (uint8_t)((w + k) % OS_READY_WORDS);
+        if(sc->ready_map[prio][v] != 0u){
+            return (OS_pos)(v * 32u + OS_PortCtz(sc->ready_map[prio][v]));
+        }
+    }
+    return OS_NO_POS;
+#endif
+}
+
+#if OS_CONFIG_CHAINS
+/**
+ * Return true if task to is reached by following the successors of task from
+ */
+static bool OS_ChainReaches(OS_sched *sc, OS_pos from, OS_pos to){
+    uint32_t reach[OS_READY_WORDS] = {0u};
+    bool grown = true;
+    reach[from / 32u] = 1u << (from % 32u);
+    while(grown){ //add successors of reached tasks until nothing is added
+        grown = false;
+        for(OS_pos t = 0u; t < OS_TASK_END(sc); t++){
+            if((reach[t / 32u] & (1u << (t % 32u))) != 0u){
+                for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+                    uint32_t add = sc->chain_next[t][w] & ~reach[w];
+                    if(add != 0u){
+                        reach[w] |= add;
+                        grown = true;
+                    }
+                }
+            }
+        }
+    }
+    return (reach[to / 32u] & (1u << (to % 32u))) != 0u;
+}
+
+/**
+ * Return true if all predecessors of a task are completed since its last trigger
+ */
+static bool OS_ChainSatisfied(OS_sched *sc, OS_pos task){
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        if((sc->chain_done[task][w] & sc->chain_prev[task][w]) != sc->chain_prev[task][w]){
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+#if !OS_CONFIG_STATIC_TASKS
+#if OS_CONFIG_CHAINS
+/**
+ * Remove all chains of a task
+ */
+static void OS_ChainClear(OS_sched *sc, OS_pos task){
+    for(OS_pos t = 0u; t < OS_TASK_END(sc); t++){
+        sc->chain_next[t][task / 32u] &= ~(1u << (task % 32u));
+        sc->chain_prev[t][task / 32u] &= ~(1u << (task % 32u));
+        sc->chain_done[t][task / 32u] &= ~(1u << (task % 32u));
+    }
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        sc->chain_next[task][w] = 0u;
+        sc->chain_prev[task][w] = 0u;
+        sc->chain_done[task][w] = 0u;
+    }
+}
+#endif
+
+/**
+ * Clear task slot, so the position can be used during new task creation
+ */
+static void OS_TaskDrop(OS_sched *sc, OS_pos task){
+    OS_TASK_FUNCTION(sc, task) = NULL;
+    OS_TASK(sc, task).task_period = 0;
+    OS_TASK(sc, task).execute_time = 0;
+    OS_TASK(sc, task).state = (uint8_t)SUSPENDED; //if task stopped, set as suspended and ignore
+    OS_TASK_DATA(sc, task) = NULL;
+    OS_TASK(sc, task).priority = 0u;
+    OS_TASK(sc, task).overrun = OS_OVERRUN_CATCH_UP;
+    OS_TASK(sc, task).burst_limit = 0u;
+    OS_TASK(sc, task).burst_count = 0u;
+#if OS_CONFIG_BUDGET
+    OS_TASK(sc, task).budget = 0u;
+    OS_TASK(sc, task).budget_action = OS_BUDGET_REPORT;
+#endif
+#if OS_CONFIG_PROFILING
+    OS_ProfileClear(sc, task);
+#endif
+#if OS_CONFIG_CHAINS
+    OS_ChainClear(sc, task);
+#endif
+#if OS_CONFIG_EDF
+    OS_TASK(sc, task).wcet = 0u;
+#endif
+#if OS_CONFIG_TASK_GROUPS
+    OS_TASK(sc, task).groups = 0u;
+#endif
+#if OS_CONFIG_FIXED_RATE
+    OS_TASK(sc, task).timed = 0u;
+#endif
+    (void)OS_PortAtomicFetchAnd(&sc->isr_ready_map[task / 32u], ~(1u << (task % 32u))); //a pending READY request does not reach the next task at the position
+    (void)OS_PortAtomicFetchAnd(&sc->post_map[task / 32u], ~(1u << (task % 32u))); //nor does a pending post
+    OS_TASK(sc, task).generation++; //invalidate handles of the dropped task
+    if(OS_TASK(sc, task).generation == 0u){
+        OS_TASK(sc, task).generation = 1u;
+    }
+    sc->task_count--; //move last live task into the hole of live list
+    OS_LIVE_LIST(sc, OS_TASK(sc, task).live_pos) = OS_LIVE_LIST(sc, sc->task_count);
+    OS_TASK(sc, OS_LIVE_LIST(sc, sc->task_count)).live_pos = OS_TASK(sc, task).live_pos;
+    OS_LIVE_LIST(sc, sc->task_count) = task; //dropped position follows the live ones
+}
+#endif
+
+#if OS_CONFIG_TASK_GROUPS
+#define OS_GROUP_MASK   ((uint32_t)(((uint64_t)1u << OS_CONFIG_TASK_GROUPS) - 1u))    /**< Bits of the groups. */
+#define OS_TASK_PERIOD(sc, task, period)    OS_GroupPeriod(sc, task, period)        /**< Period of a task scaled by its groups. */
+
+/**
+ * Return period of a task multiplied by the largest scale factor of its groups, at most OS_MAX_TIME
+ */
+static uint32_t OS_GroupPeriod(OS_sched *sc, OS_pos task, uint32_t period){
+    uint32_t bits = (uint32_t)OS_TASK(sc, task).groups & sc->group_scaled;
+    uint32_t scale = 1u;
+    while(bits != 0u){
+        uint8_t group = OS_PortCtz(bits);
+        bits &= bits - 1u;
+        if(sc->group_scale[group] > scale){
+            scale = sc->group_scale[group];
+        }
+    }
+    return (period > (OS_MAX_TIME / scale)) ? OS_MAX_TIME : (period * scale);
+}
+
+/**
+ * Return true if a group of the task is suspended
+ */
+static bool OS_GroupSuspended(OS_sched *sc, OS_pos task){
+    return ((uint32_t)OS_TASK(sc, task).groups & sc->group_suspended) != 0u;
+}
+#else
+#define OS_TASK_PERIOD(sc, task, period)    (period)
+#endif
+
+/**
+ * Move task into new state, keeping deadline heap and ready bitmap consistent
+ * BLOCKED tasks are kept in deadline heap, READY tasks in ready bitmap
+ * A STOPPED task is dropped right away, unless it is being executed, then it is dropped at the end of its execution
+ * A static task is never dropped, it stays STOPPED until its state is changed
+ * A task of a suspended group is parked in SUSPENDED state instead of READY state, it is resumed with its group
+ */
+static void OS_TaskEnterState(OS_sched *sc, OS_pos task, OS_state new_state){
+#if OS_CONFIG_TASK_GROUPS
+    sc->parked_map[task / 32u] &= ~(1u << (task % 32u)); //any state change ends parking
+    if((new_state == READY) && OS_GroupSuspended(sc, task)){
+        new_state = SUSPENDED;
+        sc->parked_map[task / 32u] |= 1u << (task % 32u);
+    }
+#endif
+#if OS_CONFIG_EDF || OS_CONFIG_FIXED_RATE
+    if(new_state == READY){ //activation starts at the release time if released by time, else now
+        OS_tasktime start = (OS_tasktime)sc->os_time;
+        if((OS_TASK(sc, task).state == BLOCKED) && (OS_TASK_TIME_DIFF(OS_TASK(sc, task).execute_time, sc->os_time) <= 0)){
+            start = OS_TASK(sc, task).execute_time;
+        }
+#if OS_CONFIG_EDF
+        OS_TASK(sc, task).deadline = (OS_tasktime)(start + OS_TASK_PERIOD(sc, task, OS_TASK(sc, task).task_period)); //end of the period
+#endif
+#if OS_CONFIG_FIXED_RATE
+        OS_TASK(sc, task).release_time = start;
+#endif
+    }
+#endif
+    if(OS_TASK(sc, task).state == BLOCKED){
+        OS_HeapRemove(sc, task);
+    }else if(OS_TASK(sc, task).state == READY){
+        OS_ReadyClear(sc, task);
+    }
+    if((new_state == STOPPED) && (OS_TASK(sc, task).state != STOPPED)){
+        OS_TRACE(sc, OS_TRACE_STOP, task);
+    }
+    OS_TASK(sc, task).state = (uint8_t)new_state;
+    if(new_state == BLOCKED){
+        OS_HeapPush(sc, task);
+    }else if(new_state == READY){
+        OS_ReadySet(sc, task);
+#if OS_CONFIG_PROFILING
+        OS_PROFILE(sc, task).release_time = sc->os_time; //time release overrides this
+#endif
+    }
+#if !OS_CONFIG_STATIC_TASKS
+    else if((new_state == STOPPED) && (sc->running != (OS_pos)(task + 1u))){
+        OS_TaskDrop(sc, task);
+    }
+#endif
+}
+
+/**
+ * Return true if an interrupt requested READY state for a task or posted a task, or another core sent a request
+ */
+static bool OS_TaskPendingRequest(OS_sched *sc){
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        if((sc->isr_ready_map[w] | sc->post_map[w]) != 0u){
+            return true;
+        }
+    }
+#if OS_CONFIG_CORES > 1
+    for(uint8_t core = 0u; core < OS_CONFIG_CORES; core++){
+        if(sc->mailbox[core].head != sc->mailbox[core].tail){
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+/**
+ * Return true if a task is READY or due to be released
+ */
+static bool OS_TaskPending(OS_sched *sc){
+#if OS_CONFIG_SOFT_TIMERS
+    if(sc->timer_time != sc->os_time){ //ticks passed since timers were checked
+        return true;
+    }
+#endif
+    return OS_TaskPendingRequest(sc) || (sc->ready_prio != 0u) || ((sc->heap_size > 0u) && (OS_TASK_TIME_DIFF(OS_TASK(sc, OS_DEADLINE_HEAP(sc, 0)).execute_time, sc->os_time) <= 0));
+}
+
+/**
+ * Return true if a task of any scheduler instance of the core is READY or due, the core sleeps only if every instance is idle
+ */
+static bool OS_CorePending(OS_sched *sc){
+#if OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES
+    uint8_t core = OS_SchedOwner(sc);
+    for(uint8_t i = 0u; i < OS_CONFIG_SCHEDULERS; i++){
+        if((OS_SchedOwner(&os_sched[i]) == core) && OS_TaskPending(&os_sched[i])){
+            return true;
+        }
+    }
+    return false;
+#else
+    return OS_TaskPending(sc);
+#endif
+}
+
+#if OS_CONFIG_SOFT_TIMERS
+#define OS_TIMER_SLOT(time) ((uint32_t)(time) & (OS_CONFIG_TIMER_WHEEL_SIZE - 1u)) /**< Wheel slot of an expire time. */
+
+/**
+ * Link timer to the head of a list
+ */
+static void OS_TimerLink(OS_timer **head, OS_timer *timer){
+    timer->next = *head;
+    if(timer->next != NULL){
+        timer->next->link = &timer->next;
+    }
+    timer->link = head;
+    *head = timer;
+}
+
+/**
+ * Unlink timer from its list, timer SHALL be linked
+ */
+static void OS_TimerUnlink(OS_timer *timer){
+    *timer->link = timer->next;
+    if(timer->next != NULL){
+        timer->next->link = timer->link;
+    }
+    timer->link = NULL;
+}
+
+/**
+ * Call the callbacks of expired timers, slots of the ticks passed since last call are visited (every slot after a full turn)
+ * A slot is taken out first, so callbacks may start and cancel any timer, timers not expired yet are linked back
+ */
+static void OS_TimerRun(OS_sched *sc){
+    uint32_t now = sc->os_time;
+    uint32_t steps = now - sc->timer_time;
+    if(steps > OS_CONFIG_TIMER_WHEEL_SIZE){
+        steps = OS_CONFIG_TIMER_WHEEL_SIZE;
+    }
+    sc->timer_time = now;
+    for(uint32_t k = 0u; k < steps; k++){
+        OS_timer *taken = NULL;
+        OS_timer **slot = &sc->timer_wheel[OS_TIMER_SLOT(now - k)];
+        while(*slot != NULL){ //move slot to the local list
+            OS_timer *timer = *slot;
+            OS_TimerUnlink(timer);
+            OS_TimerLink(&taken, timer);
+        }
+        while(taken != NULL){
+            OS_timer *timer = taken;
+            OS_TimerUnlink(timer);
+            if(OS_TIME_DIFF(timer->expire, now) <= 0){
+                timer->callback(timer->context);
+            }else{ //expires at a later turn
+                OS_TimerLink(slot, timer);
+            }
+        }
+    }
+}
+
+/**
+ * Return os time of the first timer expiry, at most one wheel turn ahead of now, or now + OS_MAX_TIME if no timer is started
+ * Expiries beyond the turn are reported as the end of the turn, the wheel is scanned again then
+ */
+static uint32_t OS_TimerNext(OS_sched *sc, uint32_t now){
+    bool started = false;
+    for(uint32_t k = 1u; k <= OS_CONFIG_TIMER_WHEEL_SIZE; k++){
+        for(const OS_timer *timer = sc->timer_wheel[OS_TIMER_SLOT(now + k)]; timer != NULL; timer = timer->next){
+            if(OS_TIME_DIFF(timer->expire, now + k) <= 0){
+                return now + k;
+            }
+            started = true;
+        }
+    }
+    return now + (started ? OS_CONFIG_TIMER_WHEEL_SIZE : OS_MAX_TIME);
+}
+#endif
+
+/**
+ * Return next execution time of a task as os time, stored time may be narrower than os time
+ */
+static uint32_t OS_TaskExecuteTime(OS_sched *sc, OS_pos task){
+    uint32_t now = sc->os_time;
+    return now + (uint32_t)OS_TASK_TIME_DIFF(OS_TASK(sc, task).execute_time, now);
+}
+
+/**
+ * Count and report missed activations of a task
+ */
+static void OS_TaskMissed(OS_sched *sc, OS_pos task, uint32_t missed){
+#if OS_CONFIG_PROFILING
+    OS_PROFILE(sc, task).missed_deadlines += missed;
+    sc->sched_profile.missed_deadlines += missed;
+#endif
+    if(deadline_hook != NULL){
+        deadline_hook(OS_TaskHandle(sc, task), missed);
+    }
+}
+
+/**
+ * Update next execution time of a task released at os time now
+ * If next release time is already reached, activations are missed, overrun policy of the task decides the next release time
+ */
+static void OS_TaskNextRelease(OS_sched *sc, OS_pos task, uint32_t now){
+    uint32_t release = now + (uint32_t)OS_TASK_TIME_DIFF(OS_TASK(sc, task).execute_time, now);
+    uint32_t period = OS_TASK_PERIOD(sc, task, OS_TASK(sc, task).task_period);
+    uint32_t next = release + period;
+    if((period == 0u) || (OS_TIME_DIFF(next, now) > 0)){ //on time
+        OS_TASK(sc, task).burst_count = 0u;
+    }else{
+        uint32_t missed = (now - release) / period; //number of release windows passed, at least 1
+        if((OS_TASK(sc, task).overrun == OS_OVERRUN_CATCH_UP) &&
+           ((OS_TASK(sc, task).burst_limit == 0u) || (OS_TASK(sc, task).burst_count < OS_TASK(sc, task).burst_limit))){
+            OS_TASK(sc, task).burst_count++; //this activation is late, next one is released right away
+            missed = 1u;
+        }else if(OS_TASK(sc, task).overrun == OS_OVERRUN_SKIP){
+            next = now + period;
+        }else{ //keep phase, or catch-up burst limit is reached
+            next = release + (missed + 1u) * period;
+            OS_TASK(sc, task).burst_count = 0u;
+        }
+        OS_TaskMissed(sc, task, missed);
+    }
+    OS_TASK(sc, task).execute_time = (OS_tasktime)next;
+}
+
+#define OS_AUTO_DEFER_SEARCH    1024u       /**< Maximal number of phases tried for OS_DEFER_AUTO. */
+#define OS_AUTO_DEFER_WINDOW    32u         /**< Phases whose load is collected by one pass over the tasks for OS_DEFER_AUTO. */
+
+/**
+ * Return greatest common divisor
+ */
+static uint32_t OS_Gcd(uint32_t a, uint32_t b){
+    while(b != 0u){
+        uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * Return defer time of a task for OS_DEFER_AUTO, the phase which shares release ticks with the least load
+ * Task released at now + phase meets task j on some tick if phase is congruent to (release_j - now) modulo gcd(period, period_j),
+ * so the load of a phase is the sum of the tasks it meets, one per task or the average execution time with profiling
+ * Load repeats with lcm of the gcds, at most period, only phases within it are tried, the earliest phase wins on equal load
+ * Phases are tried in windows, each task adds its load to the phases of a window it meets by stepping with its gcd
+ */
+static uint32_t OS_TaskAutoDefer(OS_sched *sc, OS_pos task, uint32_t period){
+    uint32_t span = 1u;
+    uint32_t best_phase = 0u;
+    uint64_t best_load = UINT64_MAX;
+    for(OS_pos t = 0u; t < OS_TASK_END(sc); t++){ //phases repeat with lcm of gcds
+        if((t != task) && ((OS_TASK(sc, t).state == BLOCKED) || (OS_TASK(sc, t).state == READY))){
+            uint32_t g = OS_Gcd(period, OS_TASK_PERIOD(sc, t, OS_TASK(sc, t).task_period));
+            span = (span / OS_Gcd(span, g)) * g; //divides period, so it does not overflow
+        }
+    }
+    if(span > OS_AUTO_DEFER_SEARCH){
+        span = OS_AUTO_DEFER_SEARCH;
+    }
+    for(uint32_t base = 0u; base < span; base += OS_AUTO_DEFER_WINDOW){
+        uint64_t load[OS_AUTO_DEFER_WINDOW] = {0u};
+        uint32_t width = ((span - base) < OS_AUTO_DEFER_WINDOW) ? (span - base) : OS_AUTO_DEFER_WINDOW;
+        for(OS_pos t = 0u; t < OS_TASK_END(sc); t++){
+            if((t != task) && ((OS_TASK(sc, t).state == BLOCKED) || (OS_TASK(sc, t).state == READY))){
+                uint32_t g = OS_Gcd(period, OS_TASK_PERIOD(sc, t, OS_TASK(sc, t).task_period));
+                int32_t d = OS_TIME_DIFF(OS_TaskExecuteTime(sc, t), sc->os_time); //release of task t may be before or after now
+                uint32_t offset = (d < 0) ? ((g - ((0u - (uint32_t)d) % g)) % g) : ((uint32_t)d % g);
+#if OS_CONFIG_PROFILING
+                const OS_profile *prof = &OS_PROFILE(sc, t);
+                uint64_t weight = (prof->activations != 0u) ? (prof->run_total / prof->activations) : 1u;
+#else
+                uint64_t weight = 1u;
+#endif
+                for(uint32_t phase = (offset + g - (base % g)) % g; phase < width; phase += g){ //first phase of the window it meets
+                    load[phase] += weight;
+                }
+            }
+        }
+        for(uint32_t phase = 0u; phase < width; phase++){
+            if(load[phase] < best_load){
+                best_load = load[phase];
+                best_phase = base + phase;
+            }
+        }
+    }
+    return best_phase;
+}
+
+#if OS_CONFIG_STATIC_TASKS
+/**
+ * Put every static task into its default state, done once by the first OS_TaskExecution()
+ */
+static void OS_TaskTableStart(OS_sched *sc){
+    for(OS_pos i = 0u; i < OS_MAX_TASK_NUM; i++){
+        uint32_t defer_time = task_table[i].defer_time;
+        if(defer_time == OS_DEFER_AUTO){
+            defer_time = (task_table[i].state == BLOCKED) ? OS_TaskAutoDefer(sc, i, task_table[i].task_period) : 0u;
+        }
+        OS_TASK(sc, i).task_period = (OS_tasktime)task_table[i].task_period;
+        OS_TASK(sc, i).execute_time = (OS_tasktime)(sc->os_time + defer_time);
+        OS_TaskEnterState(sc, i, (OS_state)task_table[i].state);
+    }
+    sc->table_started = true;
+}
+#else
+/**
+ * Save creation parameters of a task and put it into its default state
+ */
+static void OS_TaskSetup(OS_sched *sc, OS_pos position, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time){
+    if(defer_time == OS_DEFER_AUTO){
+        defer_time = (default_state == BLOCKED) ? OS_TaskAutoDefer(sc, position, default_task_period) : 0u;
+    }
+    OS_TASK(sc, position).task_period = (OS_tasktime)default_task_period;
+    OS_TASK(sc, position).execute_time = (OS_tasktime)(sc->os_time + defer_time);
+    OS_TASK_DATA(sc, position) = function_data_ptr;
+    OS_TRACE(sc, OS_TRACE_CREATE, position);
+    OS_TaskEnterState(sc, position, default_state);
+}
+#endif
+
+#if OS_CONFIG_CORES > 1
+/**
+ * Send a request to the scheduler of another core, the ring is written only by the calling core
+ */
+static OS_feedback OS_MailSend(uint8_t core, const OS_mail *mail){
+    OS_mailbox *box = &os_sched[core].mailbox[OS_PortCoreId()];
+    uint32_t head = box->head;
+    if((head - box->tail) >= OS_CONFIG_MAILBOX_SIZE){
+        return NOK_CNT_LIMIT;
+    }
+    box->mail[head % OS_CONFIG_MAILBOX_SIZE] = *mail;
+    OS_PortMemoryBarrier(); //request is written before it is published
+    box->head = head + 1u;
+    OS_SCHED_WAKE();
+    return OK;
+}
+
+/**
+ * Register tasks sent by other cores, a request is dropped if task array is full and counted for the sender
+ */
+static void OS_MailReceive(OS_sched *sc){
+    for(uint8_t core = 0u; core < OS_CONFIG_CORES; core++){
+        OS_mailbox *box = &sc->mailbox[core];
+        while(box->tail != box->head){
+            const OS_mail *mail = &box->mail[box->tail % OS_CONFIG_MAILBOX_SIZE];
+            OS_PortMemoryBarrier(); //request is read after it is published
+            if(OS_TaskHasRoom(sc)){
+                OS_pos position = OS_TaskInsertPosition(sc);
+                OS_TASK_FUNCTION(sc, position) = mail->function;
+                OS_TASK(sc, position).priority = mail->priority; //before the task can be put into ready bitmap
+                OS_TASK(sc, position).overrun = mail->overrun;
+                OS_TASK(sc, position).burst_limit = mail->burst_limit;
+#if OS_CONFIG_FIXED_RATE
+                OS_TASK(sc, position).timed = mail->timed;
+#endif
+                OS_TaskSetup(sc, position, mail->task_period, (OS_state)mail->state, mail->data_ptr, mail->defer_time);
+            }else{
+                box->lost++;
+            }
+            OS_PortMemoryBarrier(); //request is read before its slot is given back
+            box->tail++;
+        }
+    }
+}
+#endif
+
+/**
+ * Put due tasks into READY state, only the head of deadline heap is checked for each release
+ * Tasks sent by other cores are registered first
+ */
+static void OS_TaskRelease(OS_sched *sc){
+    uint32_t now = sc->os_time;
+#if OS_CONFIG_CORES > 1
+    OS_MailReceive(sc);
+#endif
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        if(sc->isr_ready_map[w] != 0u){ //READY requests from interrupts
+            uint32_t bits = OS_PortAtomicExchange(&sc->isr_ready_map[w], 0u);
+            while(bits != 0u){
+                OS_pos task = (OS_pos)(w * 32u + OS_PortCtz(bits));
+                bits &= bits - 1u;
+                if(OS_TASK_FUNCTION(sc, task) != NULL){ //not dropped meanwhile
+                    OS_TaskEnterState(sc, task, READY);
+                }
+            }
+        }
+        if(sc->post_map[w] != 0u){ //posted tasks, SUSPENDED ones ignore posts, READY ones run anyway
+            uint32_t bits = OS_PortAtomicExchange(&sc->post_map[w], 0u);
+            while(bits != 0u){
+                OS_pos task = (OS_pos)(w * 32u + OS_PortCtz(bits));
+                bits &= bits - 1u;
+                if((OS_TASK(sc, task).state == WAITING) || (OS_TASK(sc, task).state == BLOCKED)){
+                    OS_TaskEnterState(sc, task, READY); //a BLOCKED task keeps its execution time, so its periodic schedule is not changed
+                }
+            }
+        }
+    }
+    while((sc->heap_size > 0u) && (OS_TASK_TIME_DIFF(OS_TASK(sc, OS_DEADLINE_HEAP(sc, 0)).execute_time, now) <= 0)){
+        OS_pos task = OS_DEADLINE_HEAP(sc, 0);
+        OS_TRACE(sc, OS_TRACE_RELEASE, task);
+        OS_TaskEnterState(sc, task, READY);
+#if OS_CONFIG_PROFILING
+        OS_PROFILE(sc, task).release_time = OS_TaskExecuteTime(sc, task);
+#endif
+        OS_TaskNextRelease(sc, task, now);
+    }
+}
+
+/**
+ * Change task state on request of a setter
+ * In an interrupt handler or from another core only READY state can be requested, it is only marked in isr_ready_map, main loop takes it over
+ */
+static OS_feedback OS_TaskRequestState(OS_sched *sc, OS_pos task, OS_state new_state){
+    if(!OS_PortInIsr() && (OS_SchedOwner(sc) == OS_PortCoreId())){
+        OS_TaskEnterState(sc, task, new_state);
+        return OK;
+    }else if(new_state == READY){
+        OS_PortAtomicOr(&sc->isr_ready_map[task / 32u], 1u << (task % 32u));
+        OS_SCHED_WAKE();
+        return OK;
+    }else if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }else{
+        return NOK_OTHER_CORE;
+    }
+}
+
+/**
+ * Change priority of a task, a READY task is moved to the ready bitmap of its new priority
+ */
+static void OS_TaskSetPriority(OS_sched *sc, OS_pos task, uint8_t new_priority){
+    if(OS_ReadyIsSet(sc, task)){
+        OS_ReadyClear(sc, task);
+        OS_TASK(sc, task).priority = new_priority;
+        OS_ReadySet(sc, task);
+    }else{
+        OS_TASK(sc, task).priority = new_priority;
+    }
+}
+
+/**
+ * Change execute_time of a task, keeping deadline heap ordered
+ */
+static void OS_TaskUpdateExecuteTime(OS_sched *sc, OS_pos task, uint32_t new_execute_time){
+    if(OS_TASK(sc, task).state == BLOCKED){ //reorder deadline heap
+        OS_HeapRemove(sc, task);
+        OS_TASK(sc, task).execute_time = (OS_tasktime)new_execute_time;
+        OS_HeapPush(sc, task);
+    }else{
+        OS_TASK(sc, task).execute_time = (OS_tasktime)new_execute_time;
+    }
+}
+
+#if !OS_CONFIG_STATIC_TASKS
+/**
+ * @brief   This function registers the tasks.
+ *          If there is empty position in task array, inserts task to that proper position (other than the end of list).
+ *          At the beginning there is an error check for registration.
+ *          If everything is good, the input values are saved.
+ * @param   function: The task we want to call periodically.
+ * @param   default_task_period: The time it gets called periodically, this is actually updated by return value of the task function.
+ * @param   default_state: The state it starts (recommended state: BLOCKED).
+ * @param   function_data_ptr: Data to be delivered to the task function (NULL if no data).
+ * @param   defer_time: Delay time for the first execution of task function (0 if no need to delay, at most OS_MAX_TIME), or
+ *          OS_DEFER_AUTO to pick the delay which spreads the releases over the ticks (phase meeting the least load of other tasks).
+ * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ */
+OS_feedback OS_TaskCreate(fncPtr function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_feedback ret = NOK_UNKNOWN;
+
+    /* Task list is owned by main loop. */
+    if (OS_PortInIsr())
+    {
+        ret = NOK_ISR_CONTEXT;
+    }
+    /* Time limit. */
+    else if ((OS_MIN_TIME > default_task_period) || (OS_MAX_TIME < default_task_period) || ((OS_MAX_TIME < defer_time) && (OS_DEFER_AUTO != defer_time)))
+    {
+        ret = NOK_TIME_LIMIT;
+    }
+    /* Task number limit, an already registered task can still be updated. */
+    else if (!OS_TaskIsInQueue(function) && !OS_TaskHasRoom(sc))
+    {
+        ret = NOK_CNT_LIMIT;
+    }
+    /* Everything is fine, save. */
+    else
+    {
+        OS_pos position = OS_TaskFind(sc, function); //check if task laready in list
+        if(position > OS_MAX_TASK_NUM){ // a new task, insert to empty position in task array
+            position = OS_TaskInsertPosition(sc);
+            OS_TASK_FUNCTION(sc, position) = function;
+        }else{ //task already in array, take it out of the queues and update values
+            OS_TaskEnterState(sc, position, SUSPENDED);
+        }
+        OS_TaskSetup(sc, position, default_task_period, default_state, function_data_ptr, defer_time);
+        ret = OK;
+    }
+    return ret;
+}
+
+/**
+ * @brief   This function registers a new instance of a task and returns its handle.
+ *          Unlike OS_TaskCreate(), the task list is not searched for the function, so the same function can be registered
+ *          several times (e.g. with different data), each instance is then accessed by its handle.
+ * @param   function: The task we want to call periodically.
+ * @param   default_task_period: The time it gets called periodically, this is actually updated by return value of the task function.
+ * @param   default_state: The state it starts (recommended state: BLOCKED).
+ * @param   function_data_ptr: Data to be delivered to the task function (NULL if no data).
+ * @param   defer_time: Delay time for the first execution of task function (0 if no need to delay, at most OS_MAX_TIME), or
+ *          OS_DEFER_AUTO to pick the delay which spreads the releases over the ticks (phase meeting the least load of other tasks).
+ * @param   handle: Handle of the new task is written here (NULL if not needed).
+ * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ */
+OS_feedback OS_TaskCreateInstance(fncPtr function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time, OS_handle *handle)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_feedback ret = NOK_UNKNOWN;
+
+    /* Task list is owned by main loop. */
+    if (OS_PortInIsr())
+    {
+        ret = NOK_ISR_CONTEXT;
+    }
+    /* Null pointer as a task. */
+    else if (NULL == function)
+    {
+        ret = NOK_NULL_PTR;
+    }
+    /* Time limit. */
+    else if ((OS_MIN_TIME > default_task_period) || (OS_MAX_TIME < default_task_period) || ((OS_MAX_TIME < defer_time) && (OS_DEFER_AUTO != defer_time)))
+    {
+        ret = NOK_TIME_LIMIT;
+    }
+    /* Task number limit. */
+    else if (!OS_TaskHasRoom(sc))
+    {
+        ret = NOK_CNT_LIMIT;
+    }
+    /* Everything is fine, save. */
+    else
+    {
+        OS_pos position = OS_TaskInsertPosition(sc);
+        OS_TASK_FUNCTION(sc, position) = function;
+        OS_TaskSetup(sc, position, default_task_period, default_state, function_data_ptr, defer_time);
+        if(handle != NULL){ //handle of a task created as STOPPED is already stale
+            *handle = OS_TaskHandle(sc, position);
+        }
+        ret = OK;
+    }
+    return ret;
+}
+
+#if OS_CONFIG_FIXED_RATE
+/**
+ * @brief   Registers a new instance of a timed task, see OS_TaskCreateInstance().
+ *          A timed task receives the release time of its activation and its lateness (ticks from the release to the start),
+ *          e.g. a control loop compensates its sampling delay with them. Functions taking a task function take it cast to fncPtr.
+ * @param   function: The timed task we want to call periodically.
+ * @param   default_task_period: The time it gets called periodically, this is actually updated by return value of the task function.
+ * @param   default_state: The state it starts (recommended state: BLOCKED).
+ * @param   function_data_ptr: Data to be delivered to the task function (NULL if no data).
+ * @param   defer_time: Delay time for the first execution of task function (0 if no need to delay, at most OS_MAX_TIME), or
+ *          OS_DEFER_AUTO to pick the delay which spreads the releases over the ticks (phase meeting the least load of other tasks).
+ * @param   handle: Handle of the new task is written here if not NULL.
+ * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ */
+OS_feedback OS_TaskCreateTimed(fncPtrTimed function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time, OS_handle *handle)
+{
+    OS_handle created = OS_HANDLE_INVALID;
+    OS_feedback ret = OS_TaskCreateInstance((fncPtr)(void (*)(void))function, default_task_period, default_state, function_data_ptr, defer_time, &created);
+    OS_sched *sc;
+    OS_pos position = OS_HandleFind(created, &sc);
+    if(position < OS_MAX_TASK_NUM){ //not created as STOPPED, marked before its first execution
+        OS_TASK(sc, position).timed = 1u;
+    }
+    if((ret == OK) && (handle != NULL)){
+        *handle = created;
+    }
+    return ret;
+}
+#endif
+
+/**
+ * @brief   Simply create a task with basic default parameters.
+ *          A BLOCKED task is added to task list with 1ms period, no input data and 0 defer time.
+ * @param   function: The task we want to call periodically.
+ * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ */
+OS_feedback OS_TaskCreateSimple(fncPtr function)
+{
+    OS_feedback ret;
+    ret = OS_TaskCreate(function, period_1ms, BLOCKED, NULL, 0);
+    return ret;
+}
+
+/**
+ * @brief   Simply schedule a task with default parameters.
+ *          A BLOCKED task is added to task list with 1ms period and no input data, it will be first executed after given defer time.
+ * @param   function: The task we want to call periodically.
+ * @param   defer_time: Delay time for the first execution of task function (0 if no need to delay, at most OS_MAX_TIME), or
+ *          OS_DEFER_AUTO to pick the delay which spreads the releases over the ticks (phase meeting the least load of other tasks).
+ * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ */
+OS_feedback OS_TaskScheduleSimple(fncPtr function, uint32_t defer_time)
+{
+    OS_feedback ret;
+    ret = OS_TaskCreate(function, period_1ms, BLOCKED, NULL, defer_time);
+    return ret;
+}
+
+#if OS_CONFIG_CORES > 1
+/**
+ * @brief   Registers a new instance of a task on the scheduler of given core.
+ *          A task for another core is sent through the lock-free mailbox of that core and registered by its next OS_TaskExecution(),
+ *          the request is dropped there if its task array is full (counted by OS_GetMailLost()). Handle of the task can be taken by
+ *          OS_TaskGetHandle() on that core.
+ * @param   core: Index of the core, see OS_CONFIG_CORES.
+ * @param   function: The task we want to call periodically.
+ * @param   default_task_period: The time it gets called periodically, this is actually updated by return value of the task function.
+ * @param   default_state: The state it starts (recommended state: BLOCKED).
+ * @param   function_data_ptr: Data to be delivered to the task function (NULL if no data).
+ * @param   defer_time: Delay time for the first execution of task function (0 if no need to delay, at most OS_MAX_TIME), or
+ *          OS_DEFER_AUTO to pick the delay which spreads the releases over the ticks (phase meeting the least load of other tasks).
+ * @return  OS_feedback: Feedback about the success or cause of error of the registration, NOK_CNT_LIMIT if mailbox is full,
+ *          NOK_OTHER_CORE if core is out of range.
+ */
+OS_feedback OS_TaskCreateOnCore(uint8_t core, fncPtr function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time)
+{
+    OS_feedback ret = NOK_UNKNOWN;
+
+    /* Mailbox is written by main loop. */
+    if (OS_PortInIsr())
+    {
+        ret = NOK_ISR_CONTEXT;
+    }
+    else if (OS_CONFIG_CORES <= core)
+    {
+        ret = NOK_OTHER_CORE;
+    }
+    /* Own core, register right away. */
+    else if ((OS_PortCoreId() == core) && (OS_SchedSelf() == &os_sched[core]))
+    {
+        ret = OS_TaskCreateInstance(function, default_task_period, default_state, function_data_ptr, defer_time, NULL);
+    }
+    /* Null pointer as a task. */
+    else if (NULL == function)
+    {
+        ret = NOK_NULL_PTR;
+    }
+    /* Time limit. */
+    else if ((OS_MIN_TIME > default_task_period) || (OS_MAX_TIME < default_task_period) || ((OS_MAX_TIME < defer_time) && (OS_DEFER_AUTO != defer_time)))
+    {
+        ret = NOK_TIME_LIMIT;
+    }
+    /* Everything is fine, send. */
+    else
+    {
+        OS_mail mail = {function, function_data_ptr, default_task_period, defer_time, (uint8_t)default_state, 0u, OS_OVERRUN_CATCH_UP, 0u, 0u};
+        ret = OS_MailSend(core, &mail);
+    }
+    return ret;
+}
+
+/**
+ * @brief   Moves a task to the scheduler of another core, only the core of the task can move it.
+ *          Task is dropped here (handle becomes stale) and sent through the mailbox with its period, priority, overrun policy and
+ *          remaining time to its next execution. A task moving itself is executed next after its period on the new core.
+ *          Pending posts, budget, groups and statistics of the task are not moved.
+ *          OK means the task is sent, not that it is registered: if the task array of the new core is full when the request is
+ *          taken over, the task is lost on both cores. OS_GetMailLost() counts such requests, compare it before and after the
+ *          next OS_TaskExecution() of the new core, or keep room there.
+ * @param   handle: Handle of the task.
+ * @param   core: Index of the new core, see OS_CONFIG_CORES.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_CNT_LIMIT if mailbox is full,
+ *          NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if task belongs to another core or core is out of range.
+ */
+OS_feedback OS_HandleMigrate(OS_handle handle, uint8_t core)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if(ret != OK){
+        return ret;
+    }else if(core >= OS_CONFIG_CORES){
+        return NOK_OTHER_CORE;
+    }else if(sc == &os_sched[core]){
+        return OK;
+    }else{
+        OS_struct *task = &OS_TASK(sc, position);
+        OS_mail mail = {OS_TASK_FUNCTION(sc, position), OS_TASK_DATA(sc, position), task->task_period, 0u, task->state, task->priority, task->overrun, task->burst_limit, (uint8_t)OS_TASK_TIMED(sc, position)};
+        if(sc->running == (OS_pos)(position + 1u)){ //moving itself, its return value is lost
+            mail.state = (uint8_t)BLOCKED;
+            mail.defer_time = task->task_period;
+        }else if((task->state == BLOCKED) && (OS_TASK_TIME_DIFF(task->execute_time, sc->os_time) > 0)){
+            mail.defer_time = (uint32_t)OS_TASK_TIME_DIFF(task->execute_time, sc->os_time);
+        }
+        ret = OS_MailSend(core, &mail);
+        if(ret == OK){
+            OS_TaskEnterState(sc, position, STOPPED);
+        }
+        return ret;
+    }
+}
+
+/**
+ * @brief   Returns the core of a task.
+ * @param   handle: Handle of the task.
+ * @return  Index of the core whose scheduler runs the task.
+ */
+uint8_t OS_HandleGetCore(OS_handle handle)
+{
+    uint32_t sched = OS_HANDLE_CORE(handle);
+    return (sched < OS_CONFIG_SCHEDULERS) ? OS_SchedOwner(&os_sched[sched]) : (uint8_t)sched;
+}
+
+/**
+ * @brief   Returns the number of requests the calling core sent to given core (OS_TaskCreateOnCore(), OS_HandleMigrate()) which
+ *          were dropped there as its task array was full, the count wraps around.
+ * @param   core: Index of the receiving core, see OS_CONFIG_CORES.
+ * @return  Number of dropped requests, 0 if core is out of range.
+ */
+uint32_t OS_GetMailLost(uint8_t core)
+{
+    return (core < OS_CONFIG_CORES) ? os_sched[core].mailbox[OS_PortCoreId()].lost : 0u;
+}
+#endif
+
+#if OS_CONFIG_TASK_ARENA
+/**
+ * @brief   Adds task storage to the scheduler of the calling core, the slots are split into blocks of OS_CONFIG_ARENA_BLOCK
+ *          positions, each block makes room for that many more tasks. Slots left over after the last whole block are not used.
+ *          The slots SHALL stay allocated (e.g. a static array or heap memory never freed), they are never given back.
+ * @param   slots: Storage of count task positions.
+ * @param   count: Number of slots.
+ * @return  OS_feedback: OK (0) if at least one block is added, NOK_NULL_PTR if slots is NULL, NOK_ISR_CONTEXT in an interrupt handler,
+ *          NOK_CNT_LIMIT if count is less than a block or every position up to OS_CONFIG_MAX_TASKS already has storage.
+ */
+OS_feedback OS_TaskArenaAdd(OS_task_slot *slots, uint32_t count)
+{
+    static const OS_task_slot cleared; //all zero, as the positions of a fixed task array at start-up
+    OS_sched *sc = OS_SchedSelf();
+    OS_feedback ret = NOK_CNT_LIMIT;
+    if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }else if(slots == NULL){
+        return NOK_NULL_PTR;
+    }
+    while((count >= OS_CONFIG_ARENA_BLOCK) && (sc->task_capacity < OS_MAX_TASK_NUM)){
+        uint32_t capacity = (uint32_t)sc->task_capacity + OS_CONFIG_ARENA_BLOCK;
+        for(uint32_t i = 0u; i < OS_CONFIG_ARENA_BLOCK; i++){
+            slots[i] = cleared;
+        }
+        sc->arena_block[sc->task_capacity / OS_CONFIG_ARENA_BLOCK] = slots;
+        sc->task_capacity = (OS_pos)((capacity > OS_MAX_TASK_NUM) ? OS_MAX_TASK_NUM : capacity); //last block may reach over the limit
+        slots += OS_CONFIG_ARENA_BLOCK;
+        count -= OS_CONFIG_ARENA_BLOCK;
+        ret = OK;
+    }
+    return ret;
+}
+
+/**
+ * @brief   Registers the arena hook of the calling core, it is called by task creation when every position with storage is used,
+ *          so storage can be added on demand (e.g. OS_TaskArenaAdd(malloc(64 * sizeof(OS_task_slot)), 64)).
+ *          Creation fails with NOK_CNT_LIMIT if the hook adds nothing.
+ * @param   hook: Hook function, NULL to disable.
+ * @return  void
+ */
+void OS_SetArenaHook(OS_arenaHook hook)
+{
+    OS_SchedSelf()->arena_hook = hook;
+}
+
+/**
+ * @brief   Returns the number of task positions with storage of the calling core.
+ * @param   void
+ * @return  Number of tasks which can be registered without more storage.
+ */
+uint32_t OS_GetTaskCapacity(void)
+{
+    return OS_SchedSelf()->task_capacity;
+}
+#endif
+
+#endif
+
+/**
+ * @brief   Check if a task is already in array.
+ * @param   function: The task pointer which we want to check.
+ * @return  true (1) if task is in array, else false (0).
+ */
+bool OS_TaskIsInQueue(fncPtr function){
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    position = OS_TaskFind(sc, function);
+    if(position < OS_MAX_TASK_NUM)
+        return true;
+    else
+        return false;
+}
+
+/**
+ * @brief   Returns handle of a task registered by its function.
+ *          If the function is registered several times, handle of the first instance is returned.
+ * @param   function: The task pointer which we want to access.
+ * @return  Handle of the task, OS_HANDLE_INVALID if task is not in array.
+ */
+OS_handle OS_TaskGetHandle(fncPtr function){
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    position = OS_TaskFind(sc, function);
+    if(position < OS_MAX_TASK_NUM)
+        return OS_TaskHandle(sc, position);
+    else
+        return OS_HANDLE_INVALID;
+}
+
+/**
+ * Advance os time of a scheduler instance
+ */
+static void OS_SchedAdvance(OS_sched *sc, uint32_t elapsed_time){
+#if OS_CONFIG_PROFILING
+    uint32_t start = OS_Timestamp();
+#endif
+    OS_PortAtomicAdd(&sc->os_time, elapsed_time); //several interrupt sources may advance the time
+#if OS_CONFIG_PROFILING
+    uint32_t cost = OS_Timestamp() - start;
+    if(cost > sc->sched_profile.tick_max){
+        sc->sched_profile.tick_max = cost;
+    }
+    sc->sched_profile.tick_total += cost;
+    sc->sched_profile.ticks++;
+#endif
+}
+
+/**
+ * @brief   This function is the heart beat of the scheduler, it advances os time by one tick.
+ *          This function SHALL be called in a timer interrupt with OS_CONFIG_TICK_US period (not needed in tickless mode).
+ * @param   void
+ * @return  void
+ */
+void OS_TaskTimer(void)
+{
+    OS_TaskTimerAdvance(1u);
+}
+
+/**
+ * @brief   This function keeps track of the os time.
+ *          Only the clock is updated here, so the interrupt cost does not depend on the number of tasks,
+ *          due tasks are taken from the head of the deadline heap and put into READY state by OS_TaskExecution().
+ *          In tickless mode this function SHALL be called from the one-shot timer interrupt programmed by the alarm hook,
+ *          or from any other wake-up source, with the time elapsed since its previous call, os time jumps accordingly.
+ * @param   elapsed_time: Number of ticks elapsed since the previous call.
+ * @return  void
+ */
+void OS_TaskTimerAdvance(uint32_t elapsed_time)
+{
+    OS_SchedAdvance(OS_SchedSelf(), elapsed_time);
+}
+
+#if OS_CONFIG_CHAINS
+/**
+ * Mark a completed task at its successors, a successor is triggered when all its predecessors are completed
+ * Trigger acts like a post, WAITING and BLOCKED successors are put into READY state, so they run in the same execution pass
+ */
+static void OS_ChainComplete(OS_sched *sc, OS_pos task){
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        uint32_t bits = sc->chain_next[task][w];
+        while(bits != 0u){
+            OS_pos next = (OS_pos)(w * 32u + OS_PortCtz(bits));
+            bits &= bits - 1u;
+            sc->chain_done[next][task / 32u] |= 1u << (task % 32u);
+            if(OS_ChainSatisfied(sc, next)){
+                for(uint8_t d = 0u; d < OS_READY_WORDS; d++){
+                    sc->chain_done[next][d] = 0u;
+                }
+                if((OS_TASK(sc, next).state == WAITING) || (OS_TASK(sc, next).state == BLOCKED)){
+                    OS_TaskEnterState(sc, next, READY); //a BLOCKED task keeps its execution time
+                }
+            }
+        }
+    }
+}
+#endif
+
+/**
+ * Put task into its next state after execution, based on its return value
+ * If task changed its own state during execution (e.g. suspended itself), that state is kept
+ */
+static void OS_TaskFinish(OS_sched *sc, OS_pos task, uint32_t period){
+#if OS_CONFIG_CHAINS
+    OS_ChainComplete(sc, task);
+#endif
+    if(OS_TASK(sc, task).state == STOPPED){ //stopped during execution
+#if !OS_CONFIG_STATIC_TASKS
+        OS_TaskDrop(sc, task);
+#endif
+    }else if((OS_TASK(sc, task).state == READY) && !OS_ReadyIsSet(sc, task)){ //state is not changed during execution
+        if(period == period_wait){ //wait for a post, period and execution time are kept
+            OS_TaskEnterState(sc, task, WAITING);
+        }else{
+            if(period > OS_MAX_TIME){ //keep deadlines within wrap-safe distance of os time
+                period = OS_MAX_TIME;
+            }
+#if OS_CONFIG_EDF
+            if((period != period_end) && (period < OS_TASK(sc, task).task_period) && (OS_TASK(sc, task).wcet != 0u) &&
+               (OS_EdfUtilisation(sc, task, OS_TASK(sc, task).wcet, period) > 65536u)){ //shorter period would overload the core, keep the old one
+                period = OS_TASK(sc, task).task_period;
+            }
+#endif
+            if(period != OS_TASK(sc, task).task_period){ //if task period is changed by return value, update those
+                OS_TASK(sc, task).task_period = (OS_tasktime)period; //update execution period based on function return value
+#if OS_CONFIG_FIXED_RATE
+                OS_TASK(sc, task).execute_time = (OS_tasktime)(OS_TASK(sc, task).release_time + OS_TASK_PERIOD(sc, task, period)); //from the release, so execution time and latency do not shift the schedule
+#else
+                OS_TASK(sc, task).execute_time = (OS_tasktime)(sc->os_time + OS_TASK_PERIOD(sc, task, period)); //also update next execution time
+#endif
+            }
+            if(period == period_end)
+                OS_TaskEnterState(sc, task, STOPPED); //if task returns end, stop task
+            else
+                OS_TaskEnterState(sc, task, BLOCKED);
+        }
+    }
+}
+
+#if OS_CONFIG_SNAPSHOT
+#define OS_SNAPSHOT_RETRIES 4u      /**< Reads of the snapshot mirror before a reader gives up while it is written. */
+
+/**
+ * Refresh the snapshot mirror of a scheduler, readers see an odd sequence while the records are written
+ */
+static void OS_SnapshotWrite(OS_sched *sc){
+    OS_snapshot *mirror = &os_snapshot[sc - os_sched];
+    uint32_t now = sc->os_time;
+    uint32_t count = 0u;
+    mirror->sequence++;
+    OS_PortMemoryBarrier(); //odd sequence is visible before the records change
+    for(OS_pos i = 0u; i < OS_TASK_END(sc); i++){
+        if(OS_TASK_FUNCTION(sc, i) != NULL){
+            if(count < OS_CONFIG_SNAPSHOT){
+                OS_snapshot_task *record = &mirror->task[count];
+                record->handle = OS_TaskHandle(sc, i);
+                record->execute_time = now + (uint32_t)OS_TASK_TIME_DIFF(OS_TASK(sc, i).execute_time, now);
+                record->task_period = OS_TASK(sc, i).task_period;
+                record->state = OS_TASK(sc, i).state;
+                record->priority = OS_TASK(sc, i).priority;
+#if OS_CONFIG_PROFILING
+                OS_ProfileGet(sc, i, &record->stats);
+#endif
+            }
+            count++;
+        }
+    }
+    mirror->os_time = now;
+    mirror->task_count = count;
+#if OS_CONFIG_PROFILING
+    OS_ProfileSchedGet(sc, &mirror->stats);
+#endif
+    OS_PortMemoryBarrier(); //records are complete before the sequence is even again
+    mirror->sequence++;
+    sc->snapshot_time = now;
+}
+#endif
+
+/**
+ * Execution pass, at most max_tasks tasks (0 for no limit) are executed and no task is started after max_time timestamp
+ * units (0 for no limit), at least one READY task is executed. Limited passes pick tasks round-robin from the task after the
+ * last executed one, so every READY task of a priority is executed in turn
+ * Return true if tasks are left READY
+ */
+static bool OS_TaskDispatch(OS_sched *sc, uint8_t max_tasks, uint32_t max_time){
+    uint32_t period;
+    OS_pos i;
+    uint32_t dispatched = 0u;
+    uint32_t limit_start = (max_time != 0u) ? OS_Timestamp() : 0u;
+    bool bounded = (max_tasks != 0u) || (max_time != 0u);
+#if OS_USE_TIMESTAMP
+    uint32_t stamp;
+    uint32_t pass_start = OS_Timestamp();
+#endif
+#if OS_CONFIG_PROFILING
+    uint64_t busy_start = sc->sched_profile.busy_total;
+    sc->sched_profile.span_total += pass_start - sc->sched_profile.last_pass;
+    sc->sched_profile.last_pass = pass_start;
+    sc->sched_profile.passes++;
+#endif
+#if OS_CONFIG_BUDGET
+    bool pass_overrun = false;
+#endif
+#if OS_CONFIG_STATIC_TASKS
+    if(!sc->table_started){
+        OS_TaskTableStart(sc);
+    }
+#endif
+#if OS_CONFIG_SOFT_TIMERS
+    OS_TimerRun(sc);
+#endif
+    OS_TaskRelease(sc);
+    while((i = (bounded ? OS_ReadyNextFrom(sc, sc->dispatch_from) : OS_ReadyNext(sc))) != OS_NO_POS)
+    {
+        if(bounded && (((max_tasks != 0u) && (dispatched >= max_tasks)) ||
+                       ((max_time != 0u) && (dispatched != 0u) && ((OS_Timestamp() - limit_start) >= max_time)))){
+            break; //limit reached, remaining READY tasks are executed by the next call
+        }
+        dispatched++;
+        sc->dispatch_from = (OS_pos)((i + 1u) % OS_MAX_TASK_NUM); //next bounded pick starts after this task
+        OS_ReadyClear(sc, i); //state stays READY while running
+        sc->running = (OS_pos)(i + 1u);
+#if OS_CONFIG_PROFILING
+        OS_ProfileStart(sc, i);
+#endif
+#if OS_USE_TIMESTAMP
+        stamp = OS_Timestamp();
+#endif
+        OS_TRACE(sc, OS_TRACE_START, i);
+#if OS_CONFIG_FIXED_RATE
+        if(OS_TASK(sc, i).timed){
+            uint32_t now = sc->os_time;
+            OS_release release;
+            release.release = now + (uint32_t)OS_TASK_TIME_DIFF(OS_TASK(sc, i).release_time, now);
+            release.lateness = now - release.release;
+            period = ((fncPtrTimed)(void (*)(void))OS_TASK_FUNCTION(sc, i))(OS_TASK_DATA(sc, i), &release); //execute timed task, stored as fncPtr
+        }else
+#endif
+        {
+            period = OS_TASK_FUNCTION(sc, i)(OS_TASK_DATA(sc, i)); //execute task
+        }
+        OS_TRACE(sc, OS_TRACE_END, i);
+#if OS_USE_TIMESTAMP
+        stamp = OS_Timestamp() - stamp; //execution time
+#endif
+#if OS_CONFIG_PROFILING
+        OS_ProfileEnd(sc, i, stamp);
+#endif
+        sc->running = 0u;
+#if OS_CONFIG_BUDGET
+        if((OS_TASK(sc, i).budget != 0u) && (stamp > OS_TASK(sc, i).budget)){ //budget overrun, report before the task can be dropped
+            OS_handle handle = OS_TaskHandle(sc, i);
+            OS_sched *owner;
+            pass_overrun = true;
+            if(budget_hook != NULL){
+                budget_hook(handle, stamp);
+            }
+            OS_TaskFinish(sc, i, period);
+            if(OS_HandleFind(handle, &owner) == i){ //still alive
+                if(OS_TASK(sc, i).budget_action == OS_BUDGET_DEMOTE){
+                    OS_TaskSetPriority(sc, i, 0u);
+                }else if(OS_TASK(sc, i).budget_action == OS_BUDGET_SUSPEND){
+                    OS_TaskEnterState(sc, i, SUSPENDED);
+                }
+            }
+        }else
+#endif
+        {
+            OS_TaskFinish(sc, i, period);
+        }
+#if (OS_CONFIG_PRIORITY_LEVELS > 1) || OS_CONFIG_EDF
+        OS_TaskRelease(sc); //a task released meanwhile may have higher priority (earlier deadline) than the remaining READY tasks
+#endif
+    }
+#if OS_CONFIG_BUDGET
+    if((sc->watchdog_hook != NULL) && !pass_overrun && ((sc->pass_budget == 0u) || ((OS_Timestamp() - pass_start) <= sc->pass_budget))){
+        sc->watchdog_hook(); //feed only if whole pass is within budgets
+    }
+#endif
+#if OS_CONFIG_TICKLESS
+    uint32_t deadline = OS_GetNextDeadline();
+    if((sc->alarm_hook != NULL) && (deadline != sc->alarm_deadline)){ //reprogram wake-up timer only if deadline is changed
+        sc->alarm_deadline = deadline;
+        sc->alarm_hook(deadline);
+    }
+#endif
+#if OS_CONFIG_PROFILING
+    OS_ProfilePass(sc, (OS_Timestamp() - pass_start) - (uint32_t)(sc->sched_profile.busy_total - busy_start));
+#endif
+#if OS_CONFIG_SNAPSHOT
+    if((os_snapshot[sc - os_sched].sequence == 0u) || ((sc->os_time - sc->snapshot_time) >= OS_CONFIG_SNAPSHOT_PERIOD)){
+        OS_SnapshotWrite(sc);
+    }
+#endif
+    /* Idle, interrupts are masked between the check and the sleep, so a tick arriving meanwhile stays pending and wakes the core up. */
+    if((sc->idle_hook != NULL) || OS_CONFIG_IDLE_WFI){
+        uint32_t primask = OS_PortIrqSave();
+        if(!OS_CorePending(sc)){
+            OS_TRACE(sc, OS_TRACE_IDLE, 0u);
+            if(sc->idle_hook != NULL)
+                sc->idle_hook();
+            else if(OS_CONFIG_CORES > 1)
+                OS_PortWaitForEvent(); //requests from other cores are signalled by SEV
+            else
+                OS_PortWaitForInterrupt();
+        }
+        OS_PortIrqRestore(primask);
+    }
+    return sc->ready_prio != 0u;
+}
+
+/**
+ * @brief   This function puts due tasks into READY state, calls the READY tasks and then puts them back into BLOCKED state.
+ *          Only due tasks are visited, BLOCKED tasks wait in the deadline heap and READY tasks are picked from the ready bitmap in position order.
+ *          With several priority levels, the highest priority READY task is always picked next and due tasks are released after every task,
+ *          so the function returns only when no task is READY.
+ *          If no task is READY or due at the end, the idle hook is called (or WFI is executed, see OS_CONFIG_IDLE_WFI).
+ *          If return value of task indicates last time execution, its state is arranged as STOPPED and it is dropped from task list.
+ *          If return value is period_wait, task waits in WAITING state until it is posted.
+ *          If a task changes its own state during execution (e.g. suspends itself), that state is kept.
+ *          Chained successors of a completed task are put into READY state, so a chain is executed in the same pass (see OS_HandleChain()).
+ *          With a static task table, the first call puts the tasks into their default state.
+ *          This function SHALL be called in the infinite loop.
+ * @param   void
+ * @return  void
+ */
+void OS_TaskExecution(void)
+{
+    (void)OS_TaskDispatch(OS_SchedSelf(), 0u, 0u);
+}
+
+/**
+ * @brief   Bounded variant of OS_TaskExecution(), the pass stops when max_tasks tasks are executed or max_time is used up,
+ *          so the code around the call in the infinite loop is serviced with bounded latency.
+ *          At least one READY task is executed by a call, the time limit is checked before each further task,
+ *          a task is not interrupted. Tasks left READY are executed by the next call, picked round-robin from the task after
+ *          the last executed one, so no READY task of a priority is starved. No idle sleep is done while tasks are left READY.
+ * @param   max_tasks: Maximal number of tasks to be executed, 0 for no limit.
+ * @param   max_time: Time budget of the pass in timestamp units (cycle counter or hook set by OS_SetTimestampHook()), 0 for no limit.
+ * @return  True if tasks are left READY for the next call.
+ */
+bool OS_TaskExecutionBounded(uint8_t max_tasks, uint32_t max_time)
+{
+    return OS_TaskDispatch(OS_SchedSelf(), max_tasks, max_time);
+}
+
+#if OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES
+/**
+ * Return scheduler instance which can be run by the main loop of the calling core, NULL if it is not bound to the core
+ */
+static OS_sched *OS_SchedulerOwned(uint8_t sched){
+    if(sched >= OS_CONFIG_SCHEDULERS){
+        return NULL;
+    }else if(sched < OS_CONFIG_CORES){
+        return (sched == OS_PortCoreId()) ? &os_sched[sched] : NULL;
+    }else{
+        return (os_sched[sched].bound && (os_sched[sched].core == OS_PortCoreId())) ? &os_sched[sched] : NULL;
+    }
+}
+
+/**
+ * @brief   Binds a scheduler instance to the calling core, its tasks are executed by the main loop of this core.
+ *          Instances from OS_CONFIG_CORES on SHALL be bound before they are selected or executed, instances of the cores are bound
+ *          to their core from start-up. Binding an instance bound to the calling core already has no effect.
+ * @param   sched: Index of the instance, see OS_CONFIG_SCHEDULERS.
+ * @return  OS_feedback: OK (0) if successful, NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if the instance is out of range
+ *          or bound to another core.
+ */
+OS_feedback OS_SchedulerInit(uint8_t sched)
+{
+    if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }else if((sched >= OS_CONFIG_SCHEDULERS) || ((sched < OS_CONFIG_CORES) && (sched != OS_PortCoreId()))){
+        return NOK_OTHER_CORE;
+    }else if(sched < OS_CONFIG_CORES){
+        return OK;
+    }else if(os_sched[sched].bound && (os_sched[sched].core != OS_PortCoreId())){
+        return NOK_OTHER_CORE;
+    }else{
+        os_sched[sched].core = OS_PortCoreId();
+        os_sched[sched].bound = true;
+        return OK;
+    }
+}
+
+/**
+ * @brief   Selects the scheduler instance the functions act on in the main loop of the calling core (task registration, hooks,
+ *          getters, OS_TaskTimer() called from the main loop...), e.g. to register the tasks of an instance at start-up.
+ *          The instance of the core is selected at start-up. OS_SchedulerExecution() selects its instance during the pass,
+ *          so the tasks of an instance act on their own instance.
+ * @param   sched: Index of the instance, see OS_CONFIG_SCHEDULERS.
+ * @return  OS_feedback: OK (0) if successful, NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if the instance is out of range
+ *          or not bound to the calling core.
+ */
+OS_feedback OS_SchedulerSelect(uint8_t sched)
+{
+    OS_sched *sc = OS_SchedulerOwned(sched);
+    if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }else if(sc == NULL){
+        return NOK_OTHER_CORE;
+    }else{
+        os_current[OS_PortCoreId()] = sc;
+        return OK;
+    }
+}
+
+/**
+ * @brief   Returns the scheduler instance the functions act on.
+ * @param   void
+ * @return  Index of the selected instance, or of the instance being executed, the instance of the core in an interrupt handler.
+ */
+uint8_t OS_GetScheduler(void)
+{
+    return (uint8_t)(OS_SchedSelf() - os_sched);
+}
+
+/**
+ * @brief   Heart beat of a scheduler instance, advances its os time by one tick.
+ *          This function SHALL be called in the timer interrupt ticking the instance, e.g. a 100us timer of a control scheduler.
+ * @param   sched: Index of the instance, see OS_CONFIG_SCHEDULERS, out of range is ignored.
+ * @return  void
+ */
+void OS_SchedulerTimer(uint8_t sched)
+{
+    OS_SchedulerTimerAdvance(sched, 1u);
+}
+
+/**
+ * @brief   Advances os time of a scheduler instance, see OS_TaskTimerAdvance().
+ * @param   sched: Index of the instance, see OS_CONFIG_SCHEDULERS, out of range is ignored.
+ * @param   elapsed_time: Number of ticks of the instance elapsed since the previous call.
+ * @return  void
+ */
+void OS_SchedulerTimerAdvance(uint8_t sched, uint32_t elapsed_time)
+{
+    if(sched < OS_CONFIG_SCHEDULERS){
+        OS_SchedAdvance(&os_sched[sched], elapsed_time);
+    }
+}
+
+/**
+ * @brief   OS_TaskExecution() of a scheduler instance, only the tasks of the instance are visited.
+ *          Each instance bound to the core SHALL be executed in the infinite loop, e.g. the control instance around every
+ *          bounded pass of the housekeeping instance. The core sleeps in a pass only if no instance of the core has a task READY or due.
+ * @param   sched: Index of the instance, see OS_CONFIG_SCHEDULERS, instances not bound to the calling core are ignored.
+ * @return  void
+ */
+void OS_SchedulerExecution(uint8_t sched)
+{
+    (void)OS_SchedulerExecutionBounded(sched, 0u, 0u);
+}
+
+/**
+ * @brief   OS_TaskExecutionBounded() of a scheduler instance.
+ * @param   sched: Index of the instance, see OS_CONFIG_SCHEDULERS, instances not bound to the calling core are ignored.
+ * @param   max_tasks: Maximal number of tasks to be executed, 0 for no limit.
+ * @param   max_time: Time budget of the pass in timestamp units, 0 for no limit.
+ * @return  True if tasks are left READY for the next call.
+ */
+bool OS_SchedulerExecutionBounded(uint8_t sched, uint8_t max_tasks, uint32_t max_time)
+{
+    OS_sched *sc = OS_SchedulerOwned(sched);
+    OS_sched **current = &os_current[OS_PortCoreId()];
+    OS_sched *previous = *current;
+    bool left;
+    if((sc == NULL) || OS_PortInIsr()){
+        return false;
+    }
+    *current = sc; //the tasks act on their own instance
+    left = OS_TaskDispatch(sc, max_tasks, max_time);
+    *current = previous;
+    return left;
+}
+#endif
+
+/**
+ * @brief   Returns current time value of the task scheduler (OS).
+ * @param   void
+ * @return  OS time tick count (clock).
+ */
+uint32_t OS_GetOsTime(void){
+    OS_sched *sc = OS_SchedSelf();
+    return sc->os_time;
+}
+
+/**
+ * @brief   Returns the os time of the earliest upcoming task release.
+ *          This is the head of the deadline heap, if a task is already READY or overdue, next tick is returned.
+ *          If there is no task to wait for, os time is returned with maximal task period (OS_MAX_TIME) added.
+ *          With software timers the first timer expiry within a wheel turn is taken too, then it SHALL be called from the main loop.
+ * @param   void
+ * @return  Next deadline in os time ticks.
+ */
+uint32_t OS_GetNextDeadline(void){
+    OS_sched *sc = OS_SchedSelf();
+    uint32_t now = sc->os_time;
+    uint32_t remaining = OS_MAX_TIME;
+    if(OS_TaskPendingRequest(sc) || (sc->ready_prio != 0u)){ //must be handled at next tick
+        remaining = 1u;
+    }else if(sc->heap_size > 0u){
+        uint32_t execute_time = OS_TaskExecuteTime(sc, OS_DEADLINE_HEAP(sc, 0));
+        if(OS_TIME_DIFF(execute_time, now) <= 0){ //overdue, release at next tick
+            remaining = 1u;
+        }else if((execute_time - now) < remaining){ //unsigned difference is valid, deadline is ahead
+            remaining = execute_time - now;
+        }
+    }
+#if OS_CONFIG_SOFT_TIMERS
+    if(remaining > 1u){
+        uint32_t timer_next = (sc->timer_time != now) ? (now + 1u) : OS_TimerNext(sc, now); //expired timers are called at next pass
+        if((timer_next - now) < remaining){
+            remaining = timer_next - now;
+        }
+    }
+#endif
+    return now + remaining;
+}
+
+#if OS_CONFIG_TICKLESS
+/**
+ * @brief   Registers the alarm hook of tickless mode.
+ *          Hook is called at the end of OS_TaskExecution() whenever the next deadline changes (see OS_GetNextDeadline()),
+ *          it shall program a one-shot timer to wake up at given os time and call OS_TaskTimerAdvance() there.
+ * @param   hook: Hook function, NULL to disable.
+ * @return  void
+ */
+void OS_SetAlarmHook(OS_alarmHook hook)
+{
+    OS_sched *sc = OS_SchedSelf();
+    sc->alarm_hook = hook;
+    sc->alarm_deadline = sc->os_time; //force reporting at next execution pass
+}
+#endif
+
+/**
+ * @brief   Registers the idle hook, it is called at the end of OS_TaskExecution() if no task is READY or due.
+ *          Hook is called with interrupts masked, it SHALL enter a sleep mode which wakes up on a pending interrupt (e.g. WFI)
+ *          and return, pending interrupts are served after the hook returns. Hence a task release can not be missed
+ *          between the check and the sleep instruction.
+ * @param   hook: Hook function, NULL to disable (then WFI is executed if OS_CONFIG_IDLE_WFI is 1).
+ * @return  void
+ */
+void OS_SetIdleHook(OS_idleHook hook)
+{
+    OS_sched *sc = OS_SchedSelf();
+    sc->idle_hook = hook;
+}
+
+/**
+ * @brief   Returns the state of the task.
+ * @param   function: Function pointer of the task.
+ * @return  OS_state: State of the task.
+ */
+OS_state OS_GetTaskState(fncPtr function)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    position = OS_TaskFind(sc, function);
+    if(position < OS_MAX_TASK_NUM)
+        return (OS_state)OS_TASK(sc, position).state;
+    else //no such a task
+        return SUSPENDED;
+}
+
+/**
+ * @brief   Returns the period of the task.
+ * @param   function: Function pointer of the task.
+ * @return  The task period.
+ *          If task is not in list, returns 0.
+ */
+uint32_t OS_GetTaskPeriod(fncPtr function)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    position = OS_TaskFind(sc, function);
+    if(position < OS_MAX_TASK_NUM)
+        return OS_TASK(sc, position).task_period;
+    else
+        return 0;
+}
+
+/**
+ * @brief   Returns the next execution time of the task.
+ * @param   function: Function pointer of the task.
+ * @return  Next execution time of the task, when os time reaches this values, task executed.
+ *          If task is not in list, returns 0.
+ */
+uint32_t OS_GetTaskExecuteTime(fncPtr function)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    position = OS_TaskFind(sc, function);
+    if(position < OS_MAX_TASK_NUM)
+        return OS_TaskExecuteTime(sc, position);
+    else
+        return 0;
+}
+
+/**
+ * @brief   Manually changes the task state.
+ * @param   function: Function pointer of the task.
+ * @param   new_state: The new state of the task.
+ * @return  OS_feedback: OK (0) if successful.
+ *          In an interrupt handler only READY state can be set (NOK_ISR_CONTEXT otherwise), task is put into READY state by the next OS_TaskExecution().
+ */
+OS_feedback OS_SetTaskState(fncPtr function, OS_state new_state)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    position = OS_TaskFind(sc, function);
+    if(position < OS_MAX_TASK_NUM){
+        return OS_TaskRequestState(sc, position, new_state);
+    }else{
+        return NOK_NULL_PTR;
+    }
+}
+
+/**
+ * @brief   Manually changes the task period.
+ * @param   function: Function pointer of the task.
+ * @param   new_task_period: The new execution period of the task, at most OS_MAX_TIME.
+ * @return  OS_feedback: OK (0) if successful, NOK_TIME_LIMIT if period is out of range, NOK_ISR_CONTEXT in an interrupt handler,
+ *          NOK_UTILISATION if the shorter period would overload the core (EDF only, see OS_HandleSetWcet()).
+ */
+OS_feedback OS_SetTaskPeriod(fncPtr function, uint32_t new_task_period)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    if(OS_PortInIsr()){ //task list is owned by main loop
+        return NOK_ISR_CONTEXT;
+    }
+    if(new_task_period > OS_MAX_TIME){
+        return NOK_TIME_LIMIT;
+    }
+    position = OS_TaskFind(sc, function);
+    if(position >= OS_MAX_TASK_NUM){
+        return NOK_NULL_PTR;
+#if OS_CONFIG_EDF
+    }else if(OS_EdfUtilisation(sc, position, OS_TASK(sc, position).wcet, new_task_period) > 65536u){
+        return NOK_UTILISATION;
+#endif
+    }else{
+        OS_TASK(sc, position).task_period = (OS_tasktime)new_task_period;
+        return OK;
+    }
+}
+
+/**
+ * @brief   Manually changes the task execution time.
+ * @param   function: Function pointer of the task.
+ * @param   new_execute_time: The new execution time of the task.
+ * @return  OS_feedback: OK (0) if successful, NOK_ISR_CONTEXT in an interrupt handler.
+ */
+OS_feedback OS_SetTaskExecuteTime(fncPtr function, uint32_t new_execute_time)
+{
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    if(OS_PortInIsr()){ //task list is owned by main loop
+        return NOK_ISR_CONTEXT;
+    }
+    position = OS_TaskFind(sc, function);
+    if(position < OS_MAX_TASK_NUM){
+        OS_TaskUpdateExecuteTime(sc, position, new_execute_time);
+        return OK;
+    }else{
+        return NOK_NULL_PTR;
+    }
+}
+
+/**
+ * @brief   Check if a handle refers to a task in array.
+ * @param   handle: Handle of the task.
+ * @return  true (1) if task is in array, false (0) if handle is stale or invalid.
+ */
+bool OS_HandleIsValid(OS_handle handle){
+    OS_sched *sc;
+    return OS_HandleFind(handle, &sc) < OS_MAX_TASK_NUM;
+}
+
+/**
+ * @brief   Returns the state of the task.
+ * @param   handle: Handle of the task.
+ * @return  OS_state: State of the task, SUSPENDED if handle is stale or invalid.
+ */
+OS_state OS_HandleGetState(OS_handle handle)
+{
+    OS_sched *sc;
+    OS_pos position;
+    position = OS_HandleFind(handle, &sc);
+    if(position < OS_MAX_TASK_NUM)
+        return (OS_state)OS_TASK(sc, position).state;
+    else //no such a task
+        return SUSPENDED;
+}
+
+/**
+ * @brief   Returns the period of the task.
+ * @param   handle: Handle of the task.
+ * @return  The task period.
+ *          If handle is stale or invalid, returns 0.
+ */
+uint32_t OS_HandleGetPeriod(OS_handle handle)
+{
+    OS_sched *sc;
+    OS_pos position;
+    position = OS_HandleFind(handle, &sc);
+    if(position < OS_MAX_TASK_NUM)
+        return OS_TASK(sc, position).task_period;
+    else
+        return 0;
+}
+
+/**
+ * @brief   Returns the next execution time of the task.
+ * @param   handle: Handle of the task.
+ * @return  Next execution time of the task, when os time reaches this values, task executed.
+ *          If handle is stale or invalid, returns 0.
+ */
+uint32_t OS_HandleGetExecuteTime(OS_handle handle)
+{
+    OS_sched *sc;
+    OS_pos position;
+    position = OS_HandleFind(handle, &sc);
+    if(position < OS_MAX_TASK_NUM)
+        return OS_TaskExecuteTime(sc, position);
+    else
+        return 0;
+}
+
+/**
+ * @brief   Manually changes the task state.
+ * @param   handle: Handle of the task.
+ * @param   new_state: The new state of the task.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid.
+ *          In an interrupt handler or from another core only READY state can be set (NOK_ISR_CONTEXT or NOK_OTHER_CORE otherwise),
+ *          task is put into READY state by the next OS_TaskExecution() of its core.
+ */
+OS_feedback OS_HandleSetState(OS_handle handle, OS_state new_state)
+{
+    OS_sched *sc;
+    OS_pos position;
+    position = OS_HandleFind(handle, &sc);
+    if(position < OS_MAX_TASK_NUM){
+        return OS_TaskRequestState(sc, position, new_state);
+    }else{
+        return NOK_INVALID_HANDLE;
+    }
+}
+
+/**
+ * @brief   Manually changes the task period.
+ * @param   handle: Handle of the task.
+ * @param   new_task_period: The new execution period of the task, at most OS_MAX_TIME.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_TIME_LIMIT if period is out of range,
+ *          NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if task belongs to another core,
+ *          NOK_UTILISATION if the shorter period would overload the core (EDF only, see OS_HandleSetWcet()).
+ */
+OS_feedback OS_HandleSetPeriod(OS_handle handle, uint32_t new_task_period)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if(ret != OK){
+        return ret;
+    }else if(new_task_period > OS_MAX_TIME){
+        return NOK_TIME_LIMIT;
+#if OS_CONFIG_EDF
+    }else if(OS_EdfUtilisation(sc, position, OS_TASK(sc, position).wcet, new_task_period) > 65536u){
+        return NOK_UTILISATION;
+#endif
+    }else{
+        OS_TASK(sc, position).task_period = (OS_tasktime)new_task_period;
+        return OK;
+    }
+}
+
+/**
+ * @brief   Manually changes the task execution time.
+ * @param   handle: Handle of the task.
+ * @param   new_execute_time: The new execution time of the task.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_ISR_CONTEXT in an interrupt handler,
+ *          NOK_OTHER_CORE if task belongs to another core.
+ */
+OS_feedback OS_HandleSetExecuteTime(OS_handle handle, uint32_t new_execute_time)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if(ret == OK){
+        OS_TaskUpdateExecuteTime(sc, position, new_execute_time);
+    }
+    return ret;
+}
+
+/**
+ * @brief   Returns the priority of the task.
+ * @param   handle: Handle of the task.
+ * @return  Priority of the task, 0 if handle is stale or invalid.
+ */
+uint8_t OS_HandleGetPriority(OS_handle handle)
+{
+    OS_sched *sc;
+    OS_pos position;
+    position = OS_HandleFind(handle, &sc);
+    if(position < OS_MAX_TASK_NUM)
+        return OS_TASK(sc, position).priority;
+    else
+        return 0;
+}
+
+/**
+ * @brief   Manually changes the task priority, a READY task is moved to the ready bitmap of its new priority.
+ * @param   handle: Handle of the task.
+ * @param   new_priority: The new priority of the task, 0 (lowest) to OS_PRIORITY_MAX.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_PRIORITY_LIMIT if priority is out of range,
+ *          NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if task belongs to another core.
+ */
+OS_feedback OS_HandleSetPriority(OS_handle handle, uint8_t new_priority)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if(ret != OK){
+        return ret;
+    }else if(new_priority > OS_PRIORITY_MAX){
+        return NOK_PRIORITY_LIMIT;
+    }else{
+        OS_TaskSetPriority(sc, position, new_priority);
+        return OK;
+    }
+}
+
+/**
+ * @brief   Posts a task from an interrupt handler (or a task), it is executed by the next OS_TaskExecution() call.
+ *          Only a bit is set atomically, so the cost does not depend on the number of tasks.
+ *          A WAITING task (which returned period_wait) is put into READY state, a BLOCKED task is executed once more without
+ *          changing its periodic schedule, a READY task is executed once, a SUSPENDED task ignores the post.
+ * @param   handle: Handle of the task.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid.
+ */
+OS_feedback OS_TaskPostFromISR(OS_handle handle)
+{
+    OS_sched *sc;
+    OS_pos position;
+    position = OS_HandleFind(handle, &sc);
+    if(position < OS_MAX_TASK_NUM){
+        OS_TRACE(OS_SchedSelf(), OS_TRACE_POST, position);
+        OS_PortAtomicOr(&sc->post_map[position / 32u], 1u << (position % 32u));
+        OS_SCHED_WAKE();
+        return OK;
+    }else{
+        return NOK_INVALID_HANDLE;
+    }
+}
+
+#if OS_CONFIG_CHAINS
+/**
+ * @brief   Chains two tasks of one scheduler instance, task to is put into READY state when task from is completed,
+ *          so it is executed in the same OS_TaskExecution() pass. A task with several predecessors is triggered when all of them
+ *          are completed since its last trigger, a task with several successors triggers all of them (fan-in and fan-out).
+ *          Trigger acts like a post, successors usually wait in WAITING state (return period_wait), SUSPENDED ones ignore it.
+ *          Chains of a task are removed when it is dropped.
+ * @param   from: Handle of the predecessor task.
+ * @param   to: Handle of the successor task.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if a handle is stale or invalid, NOK_CHAIN_CYCLE if to is
+ *          already a predecessor of from (or the same task), NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if a task
+ *          belongs to another core, NOK_OTHER_SCHEDULER if the tasks belong to different scheduler instances.
+ */
+OS_feedback OS_HandleChain(OS_handle from, OS_handle to)
+{
+    OS_sched *sc;
+    OS_sched *sc_to;
+    OS_pos position;
+    OS_pos next;
+    OS_feedback ret = OS_HandleOwned(from, &sc, &position);
+    if(ret == OK){
+        ret = OS_HandleOwned(to, &sc_to, &next);
+    }
+    if((ret == OK) && (sc_to != sc)){ //chains link positions of one instance
+        ret = NOK_OTHER_SCHEDULER;
+    }
+    if(ret == OK){
+        if(OS_ChainReaches(sc, next, position)){
+            ret = NOK_CHAIN_CYCLE;
+        }else{
+            sc->chain_next[position][next / 32u] |= 1u << (next % 32u);
+            sc->chain_prev[next][position / 32u] |= 1u << (position % 32u);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief   Removes the chain of two tasks, see OS_HandleChain().
+ * @param   from: Handle of the predecessor task.
+ * @param   to: Handle of the successor task.
+ * @return  OS_feedback: OK (0) if successful (also if tasks are not chained), NOK_INVALID_HANDLE if a handle is stale or invalid,
+ *          NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if a task belongs to another core, NOK_OTHER_SCHEDULER if
+ *          the tasks belong to different scheduler instances.
+ */
+OS_feedback OS_HandleUnchain(OS_handle from, OS_handle to)
+{
+    OS_sched *sc;
+    OS_sched *sc_to;
+    OS_pos position;
+    OS_pos next;
+    OS_feedback ret = OS_HandleOwned(from, &sc, &position);
+    if(ret == OK){
+        ret = OS_HandleOwned(to, &sc_to, &next);
+    }
+    if((ret == OK) && (sc_to != sc)){ //chains link positions of one instance
+        ret = NOK_OTHER_SCHEDULER;
+    }
+    if(ret == OK){
+        sc->chain_next[position][next / 32u] &= ~(1u << (next % 32u));
+        sc->chain_prev[next][position / 32u] &= ~(1u << (position % 32u));
+        sc->chain_done[next][position / 32u] &= ~(1u << (position % 32u));
+    }
+    return ret;
+}
+#endif
+
+#if OS_CONFIG_TASK_GROUPS
+/**
+ * Resume a parked task whose groups are no longer suspended, it is put into READY state once for the activations missed meanwhile
+ * Its periodic schedule continues from now if its next execution time has passed
+ */
+static void OS_GroupResumeTask(OS_sched *sc, OS_pos task){
+    if(!OS_GroupSuspended(sc, task)){
+        if(OS_TASK_TIME_DIFF(OS_TASK(sc, task).execute_time, sc->os_time) <= 0){
+            OS_TASK(sc, task).execute_time = (OS_tasktime)(sc->os_time + OS_TASK_PERIOD(sc, task, OS_TASK(sc, task).task_period));
+        }
+        OS_TaskEnterState(sc, task, READY);
+    }
+}
+
+/**
+ * @brief   Sets the groups a task is a member of, see OS_GroupSuspend() and OS_GroupSetScale().
+ *          A READY task joining a suspended group is parked right away, a parked task leaving its suspended groups is resumed.
+ * @param   handle: Handle of the task.
+ * @param   groups: Groups of the task, bit g is group g, 0 for none.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_GROUP_LIMIT if a group is not
+ *          below OS_CONFIG_TASK_GROUPS, NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if task belongs to another core.
+ */
+OS_feedback OS_HandleSetGroups(OS_handle handle, uint32_t groups)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if((ret == OK) && ((groups & ~OS_GROUP_MASK) != 0u)){
+        ret = NOK_GROUP_LIMIT;
+    }
+    if(ret == OK){
+        OS_TASK(sc, position).groups = (OS_group_mask)groups;
+        if((sc->parked_map[position / 32u] & (1u << (position % 32u))) != 0u){
+            OS_GroupResumeTask(sc, position);
+        }else if(OS_ReadyIsSet(sc, position) && OS_GroupSuspended(sc, position)){
+            OS_TaskEnterState(sc, position, READY); //parked
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief   Returns the groups of a task.
+ * @param   handle: Handle of the task.
+ * @return  Groups of the task, bit g is group g, 0 if handle is stale or invalid.
+ */
+uint32_t OS_HandleGetGroups(OS_handle handle)
+{
+    OS_sched *sc;
+    OS_pos position = OS_HandleFind(handle, &sc);
+    if(position < OS_MAX_TASK_NUM){
+        return OS_TASK(sc, position).groups;
+    }else{
+        return 0u;
+    }
+}
 
 /**
- * Find and return task position if task in list
- * If task is not in list, returns and invalid position
+ * @brief   Suspends groups of the calling core, the tasks of a suspended group are not executed until it is resumed.
+ *          Instead of READY state, a member is parked in SUSPENDED state: READY members right away, the others when they are
+ *          released or posted next, so a BLOCKED member costs one more wake-up at most. The call walks the ready bitmaps of every
+ *          priority level, OS_CONFIG_PRIORITY_LEVELS x OS_MAX_TASK_NUM / 32 words, and parks the READY members found there. Tasks suspended by the user are not
+ *          resumed by OS_GroupResume(), a state set for a parked task takes it out of parking.
+ * @param   groups: Groups to suspend, bit g is group g.
+ * @return  OS_feedback: OK (0) if successful, NOK_GROUP_LIMIT if a group is not below OS_CONFIG_TASK_GROUPS, NOK_ISR_CONTEXT in an interrupt handler.
  */
-static uint8_t OS_TaskFind(fncPtr function){
-    for(uint8_t i = 0; i < task_count; i++){
-        if(task_array[i].function == function){
-            return i;
+OS_feedback OS_GroupSuspend(uint32_t groups)
+{
+    OS_sched *sc = OS_SchedSelf();
+    if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }else if((groups & ~OS_GROUP_MASK) != 0u){
+        return NOK_GROUP_LIMIT;
+    }
+    sc->group_suspended |= groups;
+    for(uint8_t p = 0u; p < OS_CONFIG_PRIORITY_LEVELS; p++){
+        for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+            uint32_t bits = sc->ready_map[p][w];
+            while(bits != 0u){
+                OS_pos task = (OS_pos)(w * 32u + OS_PortCtz(bits));
+                bits &= bits - 1u;
+                if(OS_GroupSuspended(sc, task)){
+                    OS_TaskEnterState(sc, task, READY); //parked
+                }
+            }
         }
     }
-    return OS_MAX_TASK_NUM+1; //task in not in array, return an invalid position
+    return OK;
 }
 
 /**
- * Find and return a proper position to insert task to the list
- * If there is empty position which is place of previously STOPPED (dropped) task, return this position
- * Otherwise, return the tail of the task list
+ * @brief   Resumes groups of the calling core, parked tasks not in another suspended group are put into READY state, so they are
+ *          executed once by the next OS_TaskExecution() for the activations missed meanwhile, then they continue their period.
+ *          The call walks the parked bitmap, OS_MAX_TASK_NUM / 32 words, and visits every parked task.
+ * @param   groups: Groups to resume, bit g is group g.
+ * @return  OS_feedback: OK (0) if successful, NOK_GROUP_LIMIT if a group is not below OS_CONFIG_TASK_GROUPS, NOK_ISR_CONTEXT in an interrupt handler.
  */
-static uint8_t OS_TaskInsertPosition(void){
-	uint8_t i;
-    for(i = 0; i <= task_count; i++){
-        if(task_array[i].function == NULL){
-            if(i == task_count){ //if no empty position till to the last task, add to the end of list, update task count
-                task_count++;
-            }
-            break;
-        }     
+OS_feedback OS_GroupResume(uint32_t groups)
+{
+    OS_sched *sc = OS_SchedSelf();
+    if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }else if((groups & ~OS_GROUP_MASK) != 0u){
+        return NOK_GROUP_LIMIT;
     }
-    return i;
+    sc->group_suspended &= ~groups;
+    for(uint8_t w = 0u; w < OS_READY_WORDS; w++){
+        uint32_t bits = sc->parked_map[w];
+        while(bits != 0u){
+            OS_pos task = (OS_pos)(w * 32u + OS_PortCtz(bits));
+            bits &= bits - 1u;
+            OS_GroupResumeTask(sc, task);
+        }
+    }
+    return OK;
 }
 
 /**
- * @brief   This function registers the tasks.
- *          If there is empty position in task array, inserts task to that proper position (other than the end of list).
- *          At the beginning there is an error check for registration.
- *          If everything is good, the input values are saved.
- * @param   function: The task we want to call periodically.
- * @param   default_task_period: The time it gets called periodically, this is actually updated by return value of the task function.
- * @param   default_state: The state it starts (recommended state: BLOCKED).
- * @param   function_data_ptr: Data to be delivered to the task function (NULL if no data).
- * @param   defer_time: Delay time for the first execution of task function (0 if no need to delay).
- * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ * @brief   Scales the periods of the tasks of groups of the calling core without visiting the tasks, e.g. 10 to run them 10 times slower in a low power mode.
+ *          The factor applies from the next release of a task on, to its stored period and to the period it returns alike,
+ *          OS_GetTaskPeriod() keeps returning the period without the factor. A task in several scaled groups uses the largest factor,
+ *          scaled periods are limited to OS_MAX_TIME. The factor is looked up by the groups of a task at each of its releases.
+ * @param   groups: Groups to scale, bit g is group g.
+ * @param   factor: Scale factor of the periods, 1 for the original periods.
+ * @return  OS_feedback: OK (0) if successful, NOK_GROUP_LIMIT if a group is not below OS_CONFIG_TASK_GROUPS, NOK_TIME_LIMIT if factor is 0,
+ *          NOK_ISR_CONTEXT in an interrupt handler.
  */
-OS_feedback OS_TaskCreate(fncPtr function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time)
+OS_feedback OS_GroupSetScale(uint32_t groups, uint16_t factor)
 {
-    OS_feedback ret = NOK_UNKNOWN;
-
-    /* Time limit. */
-    if ((OS_MIN_TIME > default_task_period) || (OS_MAX_TIME < default_task_period))
-    {
-        ret = NOK_TIME_LIMIT;
+    OS_sched *sc = OS_SchedSelf();
+    if(OS_PortInIsr()){
+        return NOK_ISR_CONTEXT;
+    }else if((groups & ~OS_GROUP_MASK) != 0u){
+        return NOK_GROUP_LIMIT;
+    }else if(factor == 0u){
+        return NOK_TIME_LIMIT;
     }
-    /* Task number limit. */
-    else if (OS_MAX_TASK_NUM <= task_count)
-    {
-        ret = NOK_CNT_LIMIT;
+    for(uint32_t bits = groups; bits != 0u; bits &= bits - 1u){
+        sc->group_scale[OS_PortCtz(bits)] = factor;
     }
-    /* Everything is fine, save. */
-    else
-    {
-        uint8_t position = OS_TaskFind(function); //check if task laready in list
-        if(position > OS_MAX_TASK_NUM){ // a new task, insert to empty position in task array
-            position = OS_TaskInsertPosition();
-            task_array[position].function = function;
-            task_array[position].task_period = default_task_period;
-            task_array[position].state = default_state;
-            task_array[position].execute_time = os_time + defer_time;
-            task_array[position].data_ptr = function_data_ptr;
-        }else{ //task already in array, update values
-            task_array[position].task_period = default_task_period;
-            task_array[position].state = default_state;
-            task_array[position].execute_time = os_time + defer_time;
-            task_array[position].data_ptr = function_data_ptr;
-        }
-        ret = OK;
+    if(factor > 1u){
+        sc->group_scaled |= groups;
+    }else{
+        sc->group_scaled &= ~groups;
     }
-    return ret;
+    return OK;
 }
+#endif
 
 /**
- * @brief   Simply create a task with basic default parameters.
- *          A BLOCKED task is added to task list with 1ms period, no input data and 0 defer time.
- * @param   function: The task we want to call periodically.
- * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ * @brief   Initializes event flags, all flags are cleared.
+ * @param   event: Event flags.
+ * @param   task: Task waiting on the flags, posted when a flag is set. It usually waits in WAITING state (returns period_wait).
+ * @return  void
  */
-OS_feedback OS_TaskCreateSimple(fncPtr function)
+void OS_EventInit(OS_event *event, OS_handle task)
 {
-    OS_feedback ret;
-    ret = OS_TaskCreate(function, period_1ms, BLOCKED, NULL, 0);
-    return ret;
+    event->flags = 0u;
+    event->task = task;
 }
 
 /**
- * @brief   Simply schedule a task with default parameters.
- *          A BLOCKED task is added to task list with 1ms period and no input data, it will be first executed after given defer time.
- * @param   function: The task we want to call periodically.
- * @param   defer_time: Delay time for the first execution of task function (0 if no need to delay).
- * @return  OS_feedback: Feedback about the success or cause of error of the registration.
+ * @brief   Sets event flags and posts the waiting task, it is executed by the next OS_TaskExecution() without polling.
+ *          This function can be called from interrupt handlers and other cores.
+ * @param   event: Event flags.
+ * @param   flags: Flags to set.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if waiting task is stale or invalid (flags are set anyway).
  */
-OS_feedback OS_TaskScheduleSimple(fncPtr function, uint32_t defer_time)
+OS_feedback OS_EventSet(OS_event *event, uint32_t flags)
 {
-    OS_feedback ret;
-    ret = OS_TaskCreate(function, period_1ms, BLOCKED, NULL, defer_time);
-    return ret;
+    OS_PortAtomicOr(&event->flags, flags);
+    return OS_TaskPostFromISR(event->task);
 }
 
 /**
- * @brief   Check if a task is already in array.
- * @param   function: The task pointer which we want to check.
- * @return  true (1) if task is in array, else false (0).
+ * @brief   Takes event flags, the returned flags are cleared.
+ *          A flag set after the task took its flags posts it again, so the task may return period_wait if nothing is taken.
+ * @param   event: Event flags.
+ * @param   mask: Flags to take.
+ * @return  Flags of mask which were set, 0 if none.
  */
-bool OS_TaskIsInQueue(fncPtr function){
-    uint8_t position;
-    position = OS_TaskFind(function);
-    if(position < OS_MAX_TASK_NUM)
-        return true;
-    else
-        return false;
+uint32_t OS_EventTake(OS_event *event, uint32_t mask)
+{
+    return OS_PortAtomicFetchAnd(&event->flags, ~mask) & mask;
 }
 
 /**
- * @brief   This function keeps track of the tasks' time and puts them into READY state.
- *          If any task state is STOPPED, it is cleared from the task array, to save memory.
- *          This location can be used during new task creation.
- *          This function SHALL be called in a timer interrupt with a 1ms period.
- * @param   void
+ * Return queue index following given index, indexes run to 2*count so a full queue differs from an empty one
+ */
+static uint16_t OS_QueueNext(const OS_queue *queue, uint16_t index){
+    index++;
+    return (index == (uint16_t)(2u * queue->count)) ? 0u : index;
+}
+
+/**
+ * Return message storage of a queue index
+ */
+static void *OS_QueueSlot(const OS_queue *queue, uint16_t index){
+    if(index >= queue->count){
+        index -= queue->count;
+    }
+    return &queue->buffer[(uint32_t)index * queue->item_size];
+}
+
+/**
+ * @brief   Initializes a message queue, it is empty.
+ * @param   queue: Message queue.
+ * @param   buffer: Storage of count messages of item_size bytes, aligned for the message type.
+ * @param   item_size: Size of a message in bytes.
+ * @param   count: Number of messages the queue can hold (1..32767).
+ * @param   task: Consumer task, posted when a message is committed. It usually waits in WAITING state (returns period_wait).
  * @return  void
  */
-void OS_TaskTimer(void)
+void OS_QueueInit(OS_queue *queue, void *buffer, uint16_t item_size, uint16_t count, OS_handle task)
 {
-    os_time = os_time + period_1ms;
-    for (uint8_t i = 0u; i < task_count; i++)
-    {
-        /* Ignore SUSPENDED tasks. */
-        if (task_array[i].state != SUSPENDED)
-        {
-            if(task_array[i].state == BLOCKED){
-                /* Put it into READY state. */
-                if (task_array[i].execute_time <= os_time)
-                {
-                    task_array[i].execute_time += task_array[i].task_period * period_1ms; //update next execution time
-                    task_array[i].state	= READY;
-                }
-            }else if(task_array[i].state == STOPPED){
-                //Remove stopped tasks from list
-            	task_array[i].function = NULL;
-            	task_array[i].task_period = 0;
-            	task_array[i].execute_time = 0;
-                task_array[i].state = SUSPENDED; //if task stopped, set as suspended and ignore 
-                task_array[i].data_ptr = NULL;
+    queue->buffer = buffer;
+    queue->item_size = item_size;
+    queue->count = count;
+    queue->head = 0u;
+    queue->tail = 0u;
+    queue->task = task;
+}
 
-            }
-        }
+/**
+ * @brief   Returns the storage of the next message for the producer, it is written in place and published by OS_QueueCommit().
+ *          This function can be called from interrupt handlers and other cores, by a single producer.
+ * @param   queue: Message queue.
+ * @return  Pointer to the message storage, NULL if queue is full.
+ */
+void *OS_QueueAlloc(OS_queue *queue)
+{
+    if(OS_QueueCount(queue) >= queue->count){
+        return NULL;
     }
+    return OS_QueueSlot(queue, queue->head);
 }
 
 /**
- * @brief   This function calls the READY tasks and then puts them back into BLOCKED state.
- *          If return value of task indicates last time execution, its state is arranged as STOPPED, hence can be dropped from task list
- *          This function SHALL be called in the infinite loop.
- * @param   void
+ * @brief   Publishes the message written to the storage returned by OS_QueueAlloc() and posts the consumer task.
+ *          This function can be called from interrupt handlers and other cores, by a single producer.
+ * @param   queue: Message queue.
+ * @return  OS_feedback: OK (0) if successful, NOK_CNT_LIMIT if queue is full, NOK_INVALID_HANDLE if consumer task is stale or invalid
+ *          (message is queued anyway).
+ */
+OS_feedback OS_QueueCommit(OS_queue *queue)
+{
+    if(OS_QueueCount(queue) >= queue->count){
+        return NOK_CNT_LIMIT;
+    }
+    OS_PortMemoryBarrier(); //message is written before it is published
+    queue->head = OS_QueueNext(queue, queue->head);
+    return OS_TaskPostFromISR(queue->task);
+}
+
+/**
+ * @brief   Returns the oldest message for the consumer task, it is read in place and given back by OS_QueueRelease().
+ *          Consumer shall read messages until NULL is returned before waiting again (returning period_wait),
+ *          a message committed meanwhile posts it again.
+ * @param   queue: Message queue.
+ * @return  Pointer to the message, NULL if queue is empty.
+ */
+void *OS_QueuePeek(OS_queue *queue)
+{
+    if(queue->tail == queue->head){
+        return NULL;
+    }
+    OS_PortMemoryBarrier(); //message is read after it is published
+    return OS_QueueSlot(queue, queue->tail);
+}
+
+/**
+ * @brief   Gives the oldest message back to the producer, nothing is done if queue is empty.
+ * @param   queue: Message queue.
  * @return  void
  */
-void OS_TaskExecution(void)
+void OS_QueueRelease(OS_queue *queue)
 {
-    uint32_t period;
-    for (uint8_t i = 0u; i < task_count; i++)
-    {
-        /* If it is ready, then call it.*/
-        if (READY == task_array[i].state)
-        {
-            period = task_array[i].function(task_array[i].data_ptr); //execute task
-            if(period != task_array[i].task_period){ //if task period is changed by return value, update those
-                task_array[i].task_period = period; //update execution period based on function return value
-                task_array[i].execute_time = OS_GetOsTime() + period; //also update next execution time
-            }
-            if(period == period_end)
-                task_array[i].state = STOPPED; //if task returns end, stop task
-            else
-                task_array[i].state = BLOCKED;
-        }
+    if(queue->tail != queue->head){
+        OS_PortMemoryBarrier(); //message is read before its storage is given back
+        queue->tail = OS_QueueNext(queue, queue->tail);
     }
 }
 
 /**
- * @brief   Returns current time value of the task scheduler (OS).
- * @param   void
- * @return  OS time tick count (clock).
+ * @brief   Returns the number of messages in the queue.
+ * @param   queue: Message queue.
+ * @return  Number of committed and not released messages.
  */
-uint32_t OS_GetOsTime(void){
-    return os_time;
+uint16_t OS_QueueCount(const OS_queue *queue)
+{
+    uint16_t head = queue->head;
+    uint16_t tail = queue->tail;
+    return (head >= tail) ? (uint16_t)(head - tail) : (uint16_t)(head + 2u * queue->count - tail);
 }
 
+#if OS_CONFIG_SOFT_TIMERS
 /**
- * @brief   Returns the state of the task.
- * @param   function: Function pointer of the task.
- * @return  OS_state: State of the task.
+ * @brief   Initializes a software timer, it is not started.
+ * @param   timer: Software timer.
+ * @param   callback: Function called in OS_TaskExecution() of the core which started the timer when it expires.
+ * @param   context: Data to pass callback (NULL if no data).
+ * @return  void
  */
-OS_state OS_GetTaskState(fncPtr function)
+void OS_TimerInit(OS_timer *timer, OS_timerCallback callback, void *context)
 {
-    uint8_t position;
-    position = OS_TaskFind(function);
-    if(position < OS_MAX_TASK_NUM)
-        return task_array[position].state;
-    else //no such a task
-        return SUSPENDED;
+    timer->next = NULL;
+    timer->link = NULL;
+    timer->expire = 0u;
+    timer->callback = callback;
+    timer->context = context;
+    timer->core = 0u;
 }
 
 /**
- * @brief   Returns the period of the task.
- * @param   function: Function pointer of the task.
- * @return  The task period.
- *          If task is not in list, returns 0.
+ * @brief   Starts a one-shot software timer on the calling core, a started timer is restarted with the new time.
+ *          The callback can start its own timer again for periodic timeouts, or start and cancel other timers.
+ * @param   timer: Software timer, initialized by OS_TimerInit().
+ * @param   ticks: Time until the timer expires in os time ticks (OS_MIN_TIME..OS_MAX_TIME).
+ * @return  OS_feedback: OK (0) if successful, NOK_NULL_PTR if timer has no callback, NOK_TIME_LIMIT if ticks is out of range,
+ *          NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if timer is started on another core.
  */
-uint32_t OS_GetTaskPeriod(fncPtr function)
+OS_feedback OS_TimerStart(OS_timer *timer, uint32_t ticks)
 {
-    uint8_t position;
-    position = OS_TaskFind(function);
-    if(position < OS_MAX_TASK_NUM)
-        return task_array[position].task_period;
-    else
-        return 0;
+    OS_sched *sc = OS_SchedSelf();
+    OS_feedback ret = OS_TimerCancel(timer);
+    if((ret == OK) && (timer->callback == NULL)){
+        ret = NOK_NULL_PTR;
+    }else if((ret == OK) && ((ticks < OS_MIN_TIME) || (ticks > OS_MAX_TIME))){
+        ret = NOK_TIME_LIMIT;
+    }
+    if(ret == OK){
+        timer->expire = sc->os_time + ticks;
+        timer->core = OS_PortCoreId();
+        OS_TimerLink(&sc->timer_wheel[OS_TIMER_SLOT(timer->expire)], timer);
+    }
+    return ret;
 }
 
 /**
- * @brief   Returns the next execution time of the task.
- * @param   function: Function pointer of the task.
- * @return  Next execution time of the task, when os time reaches this values, task executed.
- *          If task is not in list, returns 0.
+ * @brief   Cancels a software timer, its callback is not called. Cancelling a timer which is not started has no effect.
+ * @param   timer: Software timer.
+ * @return  OS_feedback: OK (0) if successful, NOK_ISR_CONTEXT in an interrupt handler, NOK_OTHER_CORE if timer is started on another core.
  */
-uint32_t OS_GetTaskExecuteTime(fncPtr function)
+OS_feedback OS_TimerCancel(OS_timer *timer)
 {
-    uint8_t position;
-    position = OS_TaskFind(function);
-    if(position < OS_MAX_TASK_NUM)
-        return task_array[position].execute_time;
-    else
-        return 0;
+    OS_feedback ret = OK;
+    if(OS_PortInIsr()){
+        ret = NOK_ISR_CONTEXT;
+    }else if((timer->link != NULL) && (timer->core != OS_PortCoreId())){
+        ret = NOK_OTHER_CORE;
+    }
+    if((ret == OK) && (timer->link != NULL)){
+        OS_TimerUnlink(timer);
+    }
+    return ret;
 }
 
 /**
- * @brief   Manually changes the task state.
- * @param   function: Function pointer of the task.
- * @param   new_state: The new state of the task.
- * @return  OS_feedback: OK (0) if successful.
+ * @brief   Returns true if the software timer is started and has not expired yet.
+ * @param   timer: Software timer.
+ * @return  true (1) if timer is started, else false (0).
  */
-OS_feedback OS_SetTaskState(fncPtr function, OS_state new_state)
+bool OS_TimerIsActive(const OS_timer *timer)
 {
-    uint8_t position;
-    position = OS_TaskFind(function);
-    if(position < OS_MAX_TASK_NUM){
-        task_array[position].state = new_state;
-        return OK;
-    }else{
-        return NOK_NULL_PTR;
+    return timer->link != NULL;
+}
+#endif
+
+/**
+ * @brief   Registers the timestamp source of profiling, budgets and OS_TaskExecutionBounded(), with profiling it is also called
+ *          in the timer interrupt.
+ * @param   hook: Function returning a free running counter (e.g. CPU cycles), NULL to use the DWT cycle counter.
+ * @return  void
+ */
+void OS_SetTimestampHook(OS_timestampHook hook)
+{
+    timestamp_hook = hook;
+}
+
+#if OS_CONFIG_TRACE
+/**
+ * @brief   Pauses or resumes tracing of the calling core, e.g. pause it in the deadline miss hook to keep the events before.
+ * @param   pause: True to stop writing records, false to resume.
+ * @return  void
+ */
+void OS_TracePause(bool pause)
+{
+    OS_sched *sc = OS_SchedSelf();
+    sc->trace_paused = pause;
+}
+
+/**
+ * @brief   Reads the oldest trace records of the calling core, read records are removed from the buffer.
+ *          Records are decoded by OS_TRACE_EVENT(), OS_TRACE_TASK() and OS_TRACE_DELTA(), or on the host by tools/os_trace.py.
+ *          It can be called from the idle hook to stream the trace (e.g. over UART) while the system runs.
+ * @param   records: Storage of the read records.
+ * @param   max_count: Maximal number of records to read.
+ * @return  Number of records read.
+ */
+uint32_t OS_TraceRead(uint32_t *records, uint32_t max_count)
+{
+    OS_sched *sc = OS_SchedSelf();
+    uint32_t count = 0u;
+    while(count < max_count){
+        uint32_t primask = OS_PortIrqSave(); //interrupts write records too
+        if(sc->trace_tail == sc->trace_head){
+            OS_PortIrqRestore(primask);
+            break;
+        }
+        records[count++] = sc->trace_buffer[sc->trace_tail++ % OS_CONFIG_TRACE_SIZE];
+        OS_PortIrqRestore(primask);
+    }
+    return count;
+}
+#endif
+
+#if OS_CONFIG_PROFILING
+
+/**
+ * @brief   Clears all task and scheduler statistics.
+ *          Call it once at start-up, before OS_TaskExecution() loop.
+ * @param   void
+ * @return  void
+ */
+void OS_ResetStats(void)
+{
+    OS_sched *sc = OS_SchedSelf();
+    static const OS_sched_profile cleared = {0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u};
+    for(OS_pos i = 0u; i < OS_TASK_END(sc); i++){
+        OS_ProfileClear(sc, i);
     }
+    sc->sched_profile = cleared;
+    sc->sched_profile.last_pass = OS_Timestamp();
 }
 
 /**
- * @brief   Manually changes the task period.
+ * @brief   Returns the execution statistics of the task.
  * @param   function: Function pointer of the task.
- * @param   new_task_period: The new execution period of the task.
+ * @param   stats: Statistics are written here.
  * @return  OS_feedback: OK (0) if successful.
  */
-OS_feedback OS_SetTaskPeriod(fncPtr function, uint32_t new_task_period)
+OS_feedback OS_GetTaskStats(fncPtr function, OS_task_stats *stats)
 {
-    uint8_t position;
-    position = OS_TaskFind(function);
-    if(position < OS_MAX_TASK_NUM){
-        task_array[position].task_period = new_task_period;
+    OS_sched *sc = OS_SchedSelf();
+    OS_pos position;
+    position = OS_TaskFind(sc, function);
+    if((position < OS_MAX_TASK_NUM) && (stats != NULL)){
+        OS_ProfileGet(sc, position, stats);
         return OK;
     }else{
         return NOK_NULL_PTR;
@@ -299,19 +3104,197 @@ OS_feedback OS_SetTaskPeriod(fncPtr function, uint32_t new_task_period)
 }
 
 /**
- * @brief   Manually changes the task execution time.
- * @param   function: Function pointer of the task.
- * @param   new_execute_time: The new execution time of the task.
- * @return  OS_feedback: OK (0) if successful.
+ * @brief   Returns the execution statistics of the task.
+ * @param   handle: Handle of the task.
+ * @param   stats: Statistics are written here.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid.
  */
-OS_feedback OS_SetTaskExecuteTime(fncPtr function, uint32_t new_execute_time)
+OS_feedback OS_HandleGetStats(OS_handle handle, OS_task_stats *stats)
 {
-    uint8_t position;
-    position = OS_TaskFind(function);
-    if(position < OS_MAX_TASK_NUM){
-        task_array[position].execute_time = new_execute_time;
+    OS_sched *sc;
+    OS_pos position;
+    position = OS_HandleFind(handle, &sc);
+    if(stats == NULL){
+        return NOK_NULL_PTR;
+    }else if(position < OS_MAX_TASK_NUM){
+        OS_ProfileGet(sc, position, stats);
         return OK;
     }else{
+        return NOK_INVALID_HANDLE;
+    }
+}
+
+/**
+ * @brief   Returns the scheduler wide statistics.
+ * @param   stats: Statistics are written here.
+ * @return  void
+ */
+void OS_GetSchedStats(OS_sched_stats *stats)
+{
+    OS_ProfileSchedGet(OS_SchedSelf(), stats);
+}
+#endif
+
+/**
+ * @brief   Changes what happens to the missed activations of the task, when it is released after its next release time.
+ * @param   handle: Handle of the task.
+ * @param   policy: OS_OVERRUN_CATCH_UP (default), OS_OVERRUN_SKIP or OS_OVERRUN_KEEP_PHASE.
+ * @param   burst_limit: Maximal number of back-to-back catch-up executions (0 for no limit), used by OS_OVERRUN_CATCH_UP.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_ISR_CONTEXT in an interrupt handler,
+ *          NOK_OTHER_CORE if task belongs to another core.
+ */
+OS_feedback OS_HandleSetOverrunPolicy(OS_handle handle, OS_overrun policy, uint8_t burst_limit)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if(ret == OK){
+        OS_TASK(sc, position).overrun = (uint8_t)policy;
+        OS_TASK(sc, position).burst_limit = burst_limit;
+        OS_TASK(sc, position).burst_count = 0u;
+    }
+    return ret;
+}
+
+/**
+ * @brief   Registers the deadline miss hook, it is called in OS_TaskExecution() when a task is released late
+ *          with the number of activations which missed their release window.
+ * @param   hook: Hook function, NULL to disable.
+ * @return  void
+ */
+void OS_SetDeadlineMissHook(OS_deadlineHook hook)
+{
+    deadline_hook = hook;
+}
+
+#if OS_CONFIG_EDF
+/**
+ * @brief   Declares the worst case execution time of the task for the EDF admission check.
+ *          EDF meets every deadline as long as the sum of wcet / period of the tasks which are not STOPPED stays at most 100%,
+ *          the new value is refused if it would exceed that. Tasks are created with wcet 0, i.e. they are not counted.
+ *          Period setters refuse shorter periods the same way, a shorter period returned by the task which fails the check is ignored
+ *          and the task keeps its period.
+ * @param   handle: Handle of the task.
+ * @param   wcet_us: Worst case execution time in microseconds, 0 to remove the task from the check.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_ISR_CONTEXT in an interrupt handler,
+ *          NOK_OTHER_CORE if task belongs to another core, NOK_UTILISATION if the total utilisation would exceed 100%.
+ */
+OS_feedback OS_HandleSetWcet(OS_handle handle, uint32_t wcet_us)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if((ret == OK) && (OS_EdfUtilisation(sc, position, wcet_us, (uint32_t)OS_TASK(sc, position).task_period) > 65536u)){
+        ret = NOK_UTILISATION;
+    }
+    if(ret == OK){
+        OS_TASK(sc, position).wcet = wcet_us;
+    }
+    return ret;
+}
+
+/**
+ * @brief   Returns the total utilisation declared by OS_HandleSetWcet() of the tasks of the calling core which are not STOPPED.
+ * @param   void
+ * @return  Utilisation in permille.
+ */
+uint32_t OS_GetUtilisation(void)
+{
+    OS_sched *sc = OS_SchedSelf();
+    return (uint32_t)((OS_EdfUtilisation(sc, OS_NO_POS, 0u, 0u) * 1000u) >> 16);
+}
+#endif
+
+#if OS_CONFIG_BUDGET
+/**
+ * @brief   Sets the execution time budget of the task, it is checked after every execution of the task.
+ *          If execution takes longer, the budget hook is called and the action is taken, and the watchdog is not fed for that pass.
+ * @param   handle: Handle of the task.
+ * @param   budget: Execution time budget in timestamp units (e.g. CPU cycles), 0 for no budget.
+ * @param   action: OS_BUDGET_REPORT, OS_BUDGET_DEMOTE or OS_BUDGET_SUSPEND.
+ * @return  OS_feedback: OK (0) if successful, NOK_INVALID_HANDLE if handle is stale or invalid, NOK_ISR_CONTEXT in an interrupt handler,
+ *          NOK_OTHER_CORE if task belongs to another core.
+ */
+OS_feedback OS_HandleSetBudget(OS_handle handle, uint32_t budget, OS_budget_action action)
+{
+    OS_sched *sc;
+    OS_pos position;
+    OS_feedback ret = OS_HandleOwned(handle, &sc, &position);
+    if(ret == OK){
+        OS_TASK(sc, position).budget = budget;
+        OS_TASK(sc, position).budget_action = (uint8_t)action;
+    }
+    return ret;
+}
+
+/**
+ * @brief   Registers the budget overrun hook, it is called in OS_TaskExecution() right after a task exceeded its budget.
+ * @param   hook: Hook function, NULL to disable.
+ * @return  void
+ */
+void OS_SetBudgetHook(OS_budgetHook hook)
+{
+    budget_hook = hook;
+}
+
+/**
+ * @brief   Registers the watchdog hook, it is called at the end of OS_TaskExecution() only if no task exceeded its budget
+ *          and the whole pass finished within budget. Hence a hardware watchdog (e.g. IWDG) fed there resets the system
+ *          if tasks keep overrunning or a task never returns.
+ * @param   hook: Hook function feeding the watchdog, NULL to disable.
+ * @param   budget: Budget of a whole execution pass in timestamp units, 0 for no limit.
+ * @return  void
+ */
+void OS_SetWatchdogHook(OS_watchdogHook hook, uint32_t budget)
+{
+    OS_sched *sc = OS_SchedSelf();
+    sc->watchdog_hook = hook;
+    sc->pass_budget = budget;
+}
+#endif
+
+#if OS_CONFIG_SNAPSHOT
+/**
+ * @brief   Copies the snapshot of a scheduler instance: os time, live tasks with their state, period and next execution time
+ *          (and statistics with profiling), all taken at the same time. The main loop of the instance refreshes it first, other
+ *          callers get the mirror refreshed by its last OS_TaskExecution() (see OS_CONFIG_SNAPSHOT_PERIOD). The mirror is read
+ *          under a sequence lock, no interrupt is masked and the scheduler is never waited for, so this function can be called
+ *          from interrupt handlers and other cores. A debug probe can read os_snapshot the same way.
+ * @param   sched: Index of the scheduler instance (the core index for the schedulers of the cores).
+ * @param   snapshot: Snapshot is written here, records are valid for the first task_count (at most OS_CONFIG_SNAPSHOT) tasks.
+ * @return  OS_feedback: OK (0) if successful, NOK_NULL_PTR if snapshot is NULL, NOK_OTHER_CORE if the instance is out of range,
+ *          NOK_BUSY if the mirror is being refreshed (e.g. in an interrupt handler which interrupted the refresh), try again later.
+ */
+OS_feedback OS_SnapshotRead(uint8_t sched, OS_snapshot *snapshot)
+{
+    const OS_snapshot *mirror = &os_snapshot[(sched < OS_CONFIG_SCHEDULERS) ? sched : 0u];
+    if(snapshot == NULL){
         return NOK_NULL_PTR;
+    }else if(sched >= OS_CONFIG_SCHEDULERS){
+        return NOK_OTHER_CORE;
+    }else if(!OS_PortInIsr() && (OS_SchedOwner(&os_sched[sched]) == OS_PortCoreId())){
+        OS_SnapshotWrite(&os_sched[sched]); //owner takes a fresh one
+    }
+    for(uint32_t retry = 0u; retry < OS_SNAPSHOT_RETRIES; retry++){
+        uint32_t sequence = mirror->sequence;
+        OS_PortMemoryBarrier(); //records are read after the sequence
+        if((sequence & 1u) == 0u){
+            uint32_t count = (mirror->task_count < OS_CONFIG_SNAPSHOT) ? mirror->task_count : OS_CONFIG_SNAPSHOT;
+            snapshot->os_time = mirror->os_time;
+            snapshot->task_count = mirror->task_count;
+#if OS_CONFIG_PROFILING
+            snapshot->stats = mirror->stats;
+#endif
+            for(uint32_t i = 0u; i < count; i++){
+                snapshot->task[i] = mirror->task[i];
+            }
+            OS_PortMemoryBarrier(); //records are read before the sequence is checked again
+            if(mirror->sequence == sequence){
+                snapshot->sequence = sequence;
+                return OK;
+            }
+        }
     }
+    return NOK_BUSY;
 }
+#endif
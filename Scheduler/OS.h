@@ -22,16 +22,123 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "OS_Config.h"
 
 #ifndef NULL
 #define NULL            (void *)0               /**< NULL ptr. */
 #endif
 
-#define OS_MAX_TASK_NUM ((uint8_t)25u)          /**< Maximal task number that can be registered. */
-#define OS_MAX_TIME     ((uint32_t)86400000u)   /**< Maximal time that for task period (OS_MAX_TIME*time_ticks), 24h. */
+#if OS_CONFIG_STATIC_TASKS
+#define OS_MAX_TASK_NUM ((OS_pos)OS_STATIC_TASK_NUM) /**< Number of tasks in the static task table. */
+#else
+#define OS_MAX_TASK_NUM ((OS_pos)OS_CONFIG_MAX_TASKS) /**< Maximal task number that can be registered. */
+#endif
+
+#if OS_CONFIG_STATIC_TASKS || (OS_CONFIG_MAX_TASKS < 255)
+typedef uint8_t OS_pos;                         /**< Task position, also used for heap and list positions, a static task table holds at most 254 tasks. */
+#else
+typedef uint16_t OS_pos;                        /**< Task position, also used for heap and list positions. */
+#endif
+
+#if OS_CONFIG_TASK_GROUPS > 16
+typedef uint32_t OS_group_mask;                 /**< Groups a task is a member of, bit g is group g. */
+#elif OS_CONFIG_TASK_GROUPS > 8
+typedef uint16_t OS_group_mask;                 /**< Groups a task is a member of, bit g is group g. */
+#else
+typedef uint8_t OS_group_mask;                  /**< Groups a task is a member of, bit g is group g. */
+#endif
+
+#if (OS_CONFIG_TICK_US < 10) || (1000 % OS_CONFIG_TICK_US != 0)
+#error "OS_CONFIG_TICK_US shall divide 1000 and be at least 10"
+#endif
+
+/**
+ * Conversion of times to os time ticks at compile time, e.g. OS_TICKS_US(250) or OS_TICKS_MS(20).
+ * Microseconds are rounded up to whole ticks, so a non-zero time never becomes period_end.
+ */
+#define OS_TICKS_US(us) ((uint32_t)(((uint32_t)(us) + (OS_CONFIG_TICK_US - 1u)) / OS_CONFIG_TICK_US))
+#define OS_TICKS_MS(ms) ((uint32_t)((uint32_t)(ms) * (1000u / OS_CONFIG_TICK_US)))
+
+#if OS_CONFIG_TIME_BITS == 16
+typedef uint16_t OS_tasktime;                   /**< Period and next execution time stored per task. */
+#define OS_MAX_TIME     ((uint32_t)16383u)      /**< Maximal time that for task period (OS_MAX_TIME*time_ticks), within half of the 16 bit range. */
+#elif OS_CONFIG_TIME_BITS == 32
+typedef uint32_t OS_tasktime;                   /**< Period and next execution time stored per task. */
+#if (86400000000 / OS_CONFIG_TICK_US) > 0x3FFFFFFF
+#define OS_MAX_TIME     ((uint32_t)0x3FFFFFFFu) /**< Maximal time that for task period (OS_MAX_TIME*time_ticks), within a quarter of the os time range. */
+#else
+#define OS_MAX_TIME     OS_TICKS_MS(86400000u)  /**< Maximal time that for task period (OS_MAX_TIME*time_ticks), 24h. */
+#endif
+#else
+#error "OS_CONFIG_TIME_BITS shall be 16 or 32"
+#endif
 #define OS_MIN_TIME     ((uint32_t)1u)          /**< Minimal time that for task period (OS_MIN_TIME*time_ticks). */
+#define OS_PRIORITY_MAX ((uint8_t)(OS_CONFIG_PRIORITY_LEVELS - 1u)) /**< Highest task priority, priority 0 is the lowest. */
+
+#if (OS_CONFIG_PRIORITY_LEVELS < 1) || (OS_CONFIG_PRIORITY_LEVELS > 32)
+#error "OS_CONFIG_PRIORITY_LEVELS shall be in range 1..32"
+#endif
+
+#if (OS_CONFIG_MAX_TASKS < 1) || (OS_CONFIG_MAX_TASKS > 4094)
+#error "OS_CONFIG_MAX_TASKS shall be in range 1..4094"
+#endif
+
+#if OS_CONFIG_EDF && (OS_CONFIG_PRIORITY_LEVELS > 1)
+#error "OS_CONFIG_EDF replaces priorities, OS_CONFIG_PRIORITY_LEVELS shall be 1"
+#endif
+
+#if (OS_CONFIG_TASK_GROUPS < 0) || (OS_CONFIG_TASK_GROUPS > 32)
+#error "OS_CONFIG_TASK_GROUPS shall be in range 0..32"
+#endif
+
+#if (OS_CONFIG_CORES < 1) || (OS_CONFIG_CORES > 16)
+#error "OS_CONFIG_CORES shall be in range 1..16"
+#endif
+
+#if (OS_CONFIG_SCHEDULERS < OS_CONFIG_CORES) || (OS_CONFIG_SCHEDULERS > 16)
+#error "OS_CONFIG_SCHEDULERS shall be in range OS_CONFIG_CORES..16"
+#endif
+
+#if OS_CONFIG_STATIC_TASKS && (OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES)
+#error "Static task table is supported on a single scheduler"
+#endif
+
+#if OS_CONFIG_TASK_ARENA && OS_CONFIG_STATIC_TASKS
+#error "OS_CONFIG_TASK_ARENA is used with tasks registered at run time"
+#endif
+
+#if OS_CONFIG_TASK_ARENA && ((OS_CONFIG_ARENA_BLOCK < 1) || ((OS_CONFIG_ARENA_BLOCK & (OS_CONFIG_ARENA_BLOCK - 1)) != 0))
+#error "OS_CONFIG_ARENA_BLOCK shall be a power of two"
+#endif
+
+#if OS_CONFIG_SOFT_TIMERS && ((OS_CONFIG_TIMER_WHEEL_SIZE < 1) || ((OS_CONFIG_TIMER_WHEEL_SIZE & (OS_CONFIG_TIMER_WHEEL_SIZE - 1)) != 0))
+#error "OS_CONFIG_TIMER_WHEEL_SIZE shall be a power of two"
+#endif
+
+#if OS_CONFIG_STATIC_TASKS && (OS_CONFIG_CORES > 1)
+#error "Static task table is supported on a single core"
+#endif
+
+/**
+ * Wrap-safe signed difference of two os times (a - b), os time wraps after 2^32 ticks (~49.7 days with 1ms ticks, ~5 days with 100us).
+ * Result is valid while the times are less than 2^31 ticks apart, which holds for deadlines within OS_MAX_TIME.
+ * E.g. OS_TIME_DIFF(deadline, OS_GetOsTime()) <= 0 means deadline is reached.
+ */
+#define OS_TIME_DIFF(a, b)  ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
 
 typedef uint32_t (*fncPtr)(void *);             /**< Function pointer for registering tasks. */
+typedef void (*OS_alarmHook)(uint32_t);         /**< Tickless alarm hook, receives the os time of the next deadline. */
+typedef void (*OS_idleHook)(void);              /**< Idle hook, called with interrupts masked when no task is READY. */
+typedef uint32_t (*OS_timestampHook)(void);     /**< Timestamp hook for profiling, budgets and bounded passes, returns a free running counter (e.g. CPU cycles). */
+typedef uint32_t OS_handle;                     /**< Opaque task handle, task position, scheduler and generation of the position. */
+typedef void (*OS_deadlineHook)(OS_handle, uint32_t); /**< Deadline miss hook, receives the task and the number of missed activations. */
+typedef void (*OS_budgetHook)(OS_handle, uint32_t);   /**< Budget overrun hook, receives the task and its execution time. */
+typedef void (*OS_watchdogHook)(void);          /**< Watchdog hook, feeds the hardware watchdog (e.g. IWDG reload). */
+typedef void (*OS_timerCallback)(void *);      /**< Software timer callback, receives the context of the timer. */
+typedef void (*OS_arenaHook)(void);             /**< Arena hook, called when every task position with storage is used, it may add storage by OS_TaskArenaAdd(). */
+
+#define OS_HANDLE_INVALID ((OS_handle)0u)       /**< Handle value which never refers to a task. */
+#define OS_DEFER_AUTO   ((uint32_t)0xFFFFFFFFu) /**< Defer time picked by the scheduler to spread releases of BLOCKED tasks over the ticks. */
 
 /**
  * States of the tasks.
@@ -41,21 +148,125 @@ typedef enum
     SUSPENDED,                          /**< In the SUSPENDED state the task is ignored by the timer and executer. */
     BLOCKED,                            /**< In the BLOCKED state the task waits for the timer to put it into READY state. */
     READY,                              /**< In the READY state the task is ready to be called and executed in the main function. */
-    STOPPED                             /**< In the STOPPED state the task is dropped from the task array. */
+    STOPPED,                            /**< In the STOPPED state the task is dropped from the task array (kept with a static task table, it can be restarted). */
+    WAITING                             /**< In the WAITING state the task is ignored by the timer, it is put into READY state when it is posted. */
 } OS_state;
 
+#if OS_CONFIG_FIXED_RATE
+/**
+ * Activation of a timed task (see OS_TaskCreateTimed()), e.g. for a control loop to compensate its sampling delay.
+ */
+typedef struct
+{
+    uint32_t    release;                /**< os time the activation is released at, its scheduled time if released by time. */
+    uint32_t    lateness;               /**< Ticks from the release to the start of the execution. */
+} OS_release;
+
+typedef uint32_t (*fncPtrTimed)(void *, const OS_release *); /**< Function pointer for registering timed tasks. */
+#endif
+
 /**
- * Variables of the tasks.
+ * Run time variables of the tasks, fields used by release and dispatch come first.
+ * Function and data pointers are kept in separate arrays (or in flash with a static task table), they are read only to call the task.
  */
 typedef struct
 {
-    fncPtr      function;               /**< This is the task that gets called periodically. */
-    uint32_t    task_period;            /**< The period we want to call task. */
-    uint32_t    execute_time;           /**< Next execution time of the task, if os time reaches this value, then the task is put into READY state. */
-    OS_state    state;                  /**< The current state of the task. */
-    void * 		data_ptr;				/**< data to pass task function */
+    OS_tasktime execute_time;           /**< Next execution time of the task, if os time reaches this value, then the task is put into READY state. */
+    OS_tasktime task_period;            /**< The period we want to call task. */
+    uint8_t     state;                  /**< The current state of the task, see OS_state. */
+    OS_pos      heap_pos;               /**< Position of the task in the deadline heap in BLOCKED state (in the EDF ready heap in READY state), dropped positions follow the live ones in live_list. */
+    uint8_t     priority;               /**< Priority of the task, higher value is executed first among READY tasks. */
+    uint8_t     overrun;                /**< What to do with missed activations, see OS_overrun. */
+    uint8_t     burst_limit;            /**< Maximal number of back-to-back catch-up executions, 0 for no limit. */
+    uint8_t     burst_count;            /**< Number of catch-up executions in a row. */
+#if !OS_CONFIG_STATIC_TASKS
+    OS_pos      live_pos;               /**< Position of the task in the list of live tasks. */
+#endif
+#if OS_CONFIG_BUDGET
+    uint8_t     budget_action;          /**< What to do when execution time exceeds the budget, see OS_budget_action. */
+#endif
+#if OS_CONFIG_FIXED_RATE
+    uint8_t     timed;                  /**< Function of the task is a fncPtrTimed. */
+#endif
+#if !OS_CONFIG_STATIC_TASKS
+    uint16_t    generation;             /**< Incremented whenever the position is dropped, so stale handles are detected. */
+#endif
+#if OS_CONFIG_EDF
+    OS_tasktime deadline;               /**< Absolute deadline of the current activation in READY state. */
+#endif
+#if OS_CONFIG_FIXED_RATE
+    OS_tasktime release_time;           /**< Release time of the current activation in READY state. */
+#endif
+#if OS_CONFIG_BUDGET
+    uint32_t    budget;                 /**< Execution time budget in timestamp units, 0 for no budget. */
+#endif
+#if OS_CONFIG_EDF
+    uint32_t    wcet;                   /**< Worst case execution time in microseconds for the admission check, 0 if not given. */
+#endif
+#if OS_CONFIG_TASK_GROUPS
+    OS_group_mask groups;               /**< Groups the task is a member of. */
+#endif
 } OS_struct;
 
+#if OS_CONFIG_PROFILING
+/**
+ * Profiling data of a task.
+ */
+typedef struct
+{
+    uint32_t    activations;            /**< Number of executions. */
+    uint32_t    run_min;                /**< Minimal execution time, valid if activations is not 0. */
+    uint32_t    run_max;                /**< Maximal execution time. */
+    uint64_t    run_total;              /**< Sum of execution times. */
+    uint32_t    latency_max;            /**< Maximal release-to-start latency in ticks. */
+    uint64_t    latency_total;          /**< Sum of release-to-start latencies. */
+    uint32_t    missed_deadlines;       /**< Number of missed activations. */
+    uint32_t    release_time;           /**< Release time of the current activation. */
+} OS_profile;
+#endif
+
+#if OS_CONFIG_TASK_ARENA
+/**
+ * Storage of a task position in the arena (see OS_TaskArenaAdd()), allocate them as an array, e.g. static OS_task_slot slots[64].
+ * Entries of the scheduler lists and heaps at this position are kept here too, so the storage grows with the positions.
+ */
+typedef struct
+{
+    OS_struct   task;                   /**< Run time variables of the task. */
+    fncPtr      function;               /**< Function of the task, NULL if position is dropped. */
+    void *      data_ptr;               /**< Data to pass task function. */
+    OS_pos      live_entry;             /**< Entry of the list of live tasks at this position. */
+    OS_pos      heap_entry;             /**< Entry of the deadline heap at this position. */
+#if OS_CONFIG_EDF
+    OS_pos      ready_entry;            /**< Entry of the ready heap at this position. */
+#endif
+#if OS_CONFIG_PROFILING
+    OS_profile  profile;                /**< Profiling data of the task. */
+#endif
+} OS_task_slot;
+#endif
+
+/**
+ * Overrun policies, what happens when a task is released after its next release time is already reached
+ * (e.g. an earlier task executed for longer than the period).
+ */
+typedef enum
+{
+    OS_OVERRUN_CATCH_UP,                /**< Missed activations are executed back-to-back, at most burst_limit of them in a row, then the rest is skipped keeping the phase. */
+    OS_OVERRUN_SKIP,                    /**< Missed activations are dropped, next release is one period after the late release (phase is shifted). */
+    OS_OVERRUN_KEEP_PHASE               /**< Missed activations are dropped, next release is the next one on the original period grid. */
+} OS_overrun;
+
+/**
+ * Actions taken when a task executes longer than its budget, the budget hook is called in any case.
+ */
+typedef enum
+{
+    OS_BUDGET_REPORT,                   /**< Only report the overrun. */
+    OS_BUDGET_DEMOTE,                   /**< Lower the task to priority 0. */
+    OS_BUDGET_SUSPEND                   /**< Put the task into SUSPENDED state. */
+} OS_budget_action;
+
 /**
  * Feedback and error handling for the task creation and queries.
  */
@@ -65,36 +276,301 @@ typedef enum
     NOK_NULL_PTR,                       /**< ERROR: Null pointer as a task. */
     NOK_TIME_LIMIT,                     /**< ERROR: The time period is more or less, than the limits. */
     NOK_CNT_LIMIT,                      /**< ERROR: Something horrible happened, consider to increase OS_MAX_TASK_NUM. */
+    NOK_INVALID_HANDLE,                 /**< ERROR: Handle does not refer to a task, or the task is already dropped. */
+    NOK_PRIORITY_LIMIT,                 /**< ERROR: Priority is higher than OS_PRIORITY_MAX. */
+    NOK_ISR_CONTEXT,                    /**< ERROR: Function is not allowed in an interrupt handler, call it from the main loop (task) context. */
+    NOK_OTHER_CORE,                     /**< ERROR: Task belongs to the scheduler of another core, only READY state and posts can be requested. */
+    NOK_CHAIN_CYCLE,                    /**< ERROR: Chain would make a task its own predecessor. */
+    NOK_UTILISATION,                    /**< ERROR: Total utilisation of the tasks would exceed 100%, EDF can not meet all deadlines. */
+    NOK_GROUP_LIMIT,                    /**< ERROR: Group is not below OS_CONFIG_TASK_GROUPS. */
+    NOK_BUSY,                           /**< ERROR: Data is being updated by the main loop, try again later. */
+    NOK_OTHER_SCHEDULER,                /**< ERROR: Tasks belong to different scheduler instances. */
     NOK_UNKNOWN
 } OS_feedback;
 
 /**
- * Task period time.
+ * Task period time in os time ticks, see OS_CONFIG_TICK_US.
  */
 typedef enum
 {
     period_end,                         /**< task is stopped, ie last time execution, or a task which is executed once can return this */
-    period_1ms = 1,                     /**< 1 ms */
+    period_1ms = OS_TICKS_MS(1),        /**< 1 ms */
     period_10ms = period_1ms * 10,      /**< 10 ms */
     period_100ms = period_1ms * 100,    /**< 100 ms */
     period_1s = period_1ms * 1000,      /**< 1 second */
     period_1m = period_1ms * 1000 * 60, /**< 1 minute */
-    period_1h = period_1m * 60          /**< 1 hour */
+    period_1h = period_1m * 60,         /**< 1 hour */
+    period_wait = 0x7FFFFFFF            /**< task waits in WAITING state until it is posted (see OS_TaskPostFromISR()), period and execution time are kept */
 } task_period;
 
+#if OS_CONFIG_STATIC_TASKS
+#include OS_CONFIG_TASK_TABLE
+
+#define OS_TASK_ID(name, function, period, state, data_ptr, defer_time) OS_TASK_##name,
+
+/**
+ * Positions of the tasks in the static task table, OS_TASK_<name> for every entry.
+ */
+enum
+{
+    OS_TASK_TABLE(OS_TASK_ID)
+    OS_STATIC_TASK_NUM                  /**< Number of tasks in the static task table. */
+};
+
+#define OS_TASK_HANDLE(name) (((OS_handle)1u << 16) | (OS_handle)OS_TASK_##name) /**< Handle of a static task, it never becomes stale. */
+#endif
+
+
+/*
+ * Interrupt handlers only advance the os time and request READY state, the main loop (OS_TaskExecution() and tasks) owns
+ * everything else. Functions returning OS_feedback which change tasks return NOK_ISR_CONTEXT in an interrupt handler,
+ * except OS_SetTaskState()/OS_HandleSetState() with READY, which is handed over to the main loop by an atomic bitmap.
+ * OS_TaskTimer(), OS_TaskTimerAdvance(), OS_TaskPostFromISR() and the getters are interrupt safe, so are OS_EventSet() and
+ * the producer side of a queue (OS_QueueAlloc(), OS_QueueCommit()).
+ * With several cores, the same rules hold between cores: a task is changed only by the main loop of its own core,
+ * other cores may request READY state, post it, or hand over new tasks through the mailbox (NOK_OTHER_CORE otherwise).
+ * With several scheduler instances on a core, the functions act on the instance selected by OS_SchedulerSelect() or being executed,
+ * interrupt handlers always act on the instance of the core, tasks of every instance of the core can be changed through handles.
+ */
+
+#if OS_CONFIG_PROFILING
+/**
+ * Execution statistics of a task, collected since task creation or OS_ResetStats().
+ */
+typedef struct
+{
+    uint32_t    activations;            /**< Number of executions. */
+    uint32_t    run_min;                /**< Minimal execution time, in timestamp units (e.g. CPU cycles). */
+    uint32_t    run_max;                /**< Maximal execution time, in timestamp units. */
+    uint32_t    run_avg;                /**< Average execution time, in timestamp units. */
+    uint32_t    latency_max;            /**< Maximal release-to-start latency, in os time ticks. */
+    uint32_t    latency_avg;            /**< Average release-to-start latency, in os time ticks. */
+    uint32_t    missed_deadlines;       /**< Number of activations which missed their release window (executed late or dropped, see OS_overrun). */
+} OS_task_stats;
+
+/**
+ * Scheduler wide statistics, collected since OS_ResetStats().
+ */
+typedef struct
+{
+    uint32_t    passes;                 /**< Number of OS_TaskExecution() calls. */
+    uint32_t    activations;            /**< Number of task executions. */
+    uint32_t    missed_deadlines;       /**< Sum of missed deadlines of all tasks. */
+    uint32_t    ticks;                  /**< Number of OS_TaskTimer()/OS_TaskTimerAdvance() calls. */
+    uint32_t    tick_isr_max;           /**< Maximal cost of a timer call, in timestamp units. */
+    uint32_t    tick_isr_avg;           /**< Average cost of a timer call, in timestamp units. */
+    uint32_t    dispatch_max;           /**< Maximal cost of an execution pass without the tasks (release, pick, hooks), in timestamp units. */
+    uint32_t    dispatch_avg;           /**< Average cost of an execution pass without the tasks, in timestamp units. */
+    uint32_t    idle_permille;          /**< Share of time not spent in tasks, in 1/1000, measured between execution passes. */
+} OS_sched_stats;
+#endif
+
+#if OS_CONFIG_SNAPSHOT
+/**
+ * Record of a live task in the snapshot mirror.
+ */
+typedef struct
+{
+    OS_handle   handle;                 /**< Handle of the task. */
+    uint32_t    execute_time;           /**< Next execution time of the task. */
+    uint32_t    task_period;            /**< Period of the task. */
+    uint8_t     state;                  /**< State of the task, see OS_state. */
+    uint8_t     priority;               /**< Priority of the task. */
+#if OS_CONFIG_PROFILING
+    OS_task_stats stats;                /**< Execution statistics of the task. */
+#endif
+} OS_snapshot_task;
+
+/**
+ * Snapshot of a scheduler instance, records are consistent if sequence is even and the same before and after reading them.
+ */
+typedef struct
+{
+    volatile uint32_t sequence;         /**< Incremented before and after every refresh, odd while the records are written. */
+    uint32_t    os_time;                /**< os time of the refresh. */
+    uint32_t    task_count;             /**< Number of live tasks, records are given for the first OS_CONFIG_SNAPSHOT of them. */
+#if OS_CONFIG_PROFILING
+    OS_sched_stats stats;               /**< Scheduler wide statistics. */
+#endif
+    OS_snapshot_task task[OS_CONFIG_SNAPSHOT]; /**< Live tasks in position order. */
+} OS_snapshot;
+
+extern OS_snapshot os_snapshot[OS_CONFIG_SCHEDULERS]; /**< Mirror of every scheduler instance, read by OS_SnapshotRead() or a debug probe. */
+#endif
+
+/**
+ * Event flags of a task, set by tasks or interrupts and taken by the task waiting on them (see OS_EventSet()).
+ */
+typedef struct
+{
+    volatile uint32_t flags;            /**< Flags set and not taken yet, changed atomically. */
+    OS_handle   task;                   /**< Task posted when a flag is set. */
+} OS_event;
+
+/**
+ * Fixed size message queue with a single producer (task or interrupt) and a single consumer task.
+ * Messages are written and read in place (see OS_QueueAlloc(), OS_QueuePeek()), nothing is copied.
+ */
+typedef struct
+{
+    uint8_t     *buffer;                /**< Storage of count messages of item_size bytes. */
+    uint16_t    item_size;              /**< Size of a message in bytes. */
+    uint16_t    count;                  /**< Number of messages the queue can hold (1..32767). */
+    volatile uint16_t head;             /**< Next message to commit, 0..2*count-1, written by the producer. */
+    volatile uint16_t tail;             /**< Next message to release, 0..2*count-1, written by the consumer. */
+    OS_handle   task;                   /**< Consumer task posted when a message is committed. */
+} OS_queue;
+
+#if OS_CONFIG_SOFT_TIMERS
+typedef struct OS_timer OS_timer;
+
+/**
+ * One-shot software timer, its callback is called by OS_TaskExecution() of the core which started it (see OS_TimerStart()).
+ * Timers are linked into a slot of the timing wheel, the storage is given by the caller and SHALL stay valid while started.
+ */
+struct OS_timer
+{
+    OS_timer    *next;                  /**< Next timer in the same wheel slot. */
+    OS_timer    **link;                 /**< Pointer referring to this timer in the slot, NULL if the timer is not started. */
+    uint32_t    expire;                 /**< os time the timer expires at. */
+    OS_timerCallback callback;          /**< Function called when the timer expires. */
+    void *      context;                /**< Data to pass callback. */
+    uint8_t     core;                   /**< Core of the wheel the timer is started on. */
+};
+#endif
+
+#if OS_CONFIG_TRACE
+/**
+ * Trace events, bits 0..3 of a trace record.
+ */
+typedef enum
+{
+    OS_TRACE_RELEASE,                   /**< Task is released by time. */
+    OS_TRACE_START,                     /**< Task execution starts. */
+    OS_TRACE_END,                       /**< Task execution ends. */
+    OS_TRACE_CREATE,                    /**< Task is created (or its creation parameters are renewed). */
+    OS_TRACE_STOP,                      /**< Task is STOPPED. */
+    OS_TRACE_POST,                      /**< Task is posted (e.g. from an interrupt), recorded on the posting core. */
+    OS_TRACE_IDLE,                      /**< Execution pass goes idle, task field is unused. */
+    OS_TRACE_LOST,                      /**< Records were dropped as buffer was full, task field is the count (at most 255). */
+    OS_TRACE_EXT                        /**< Bits 4..31 are bits 20..47 of the delta of next record. */
+} OS_trace_event;
+
+/*
+ * Fields of a trace record: event, task position and timestamp delta to the previous record.
+ */
+#define OS_TRACE_EVENT(record)  ((OS_trace_event)((record) & 0x0Fu))
+#define OS_TRACE_TASK(record)   ((uint8_t)(((record) >> 4) & 0xFFu))
+#define OS_TRACE_DELTA(record)  ((uint32_t)(record) >> 12)
+#endif
 
+#if !OS_CONFIG_STATIC_TASKS
 OS_feedback OS_TaskCreate(fncPtr function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time);
 OS_feedback OS_TaskCreateSimple(fncPtr function);
 OS_feedback OS_TaskScheduleSimple(fncPtr function, uint32_t defer_time);
+OS_feedback OS_TaskCreateInstance(fncPtr function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time, OS_handle *handle);
+#if OS_CONFIG_FIXED_RATE
+OS_feedback OS_TaskCreateTimed(fncPtrTimed function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time, OS_handle *handle);
+#endif
+#endif
+#if OS_CONFIG_CORES > 1
+OS_feedback OS_TaskCreateOnCore(uint8_t core, fncPtr function, uint32_t default_task_period, OS_state default_state, void *function_data_ptr, uint32_t defer_time);
+OS_feedback OS_HandleMigrate(OS_handle handle, uint8_t core);
+uint8_t OS_HandleGetCore(OS_handle handle);
+uint32_t OS_GetMailLost(uint8_t core);
+#endif
+#if OS_CONFIG_TASK_ARENA
+OS_feedback OS_TaskArenaAdd(OS_task_slot *slots, uint32_t count);
+void OS_SetArenaHook(OS_arenaHook hook);
+uint32_t OS_GetTaskCapacity(void);
+#endif
 bool OS_TaskIsInQueue(fncPtr function);
+OS_handle OS_TaskGetHandle(fncPtr function);
 void OS_TaskTimer(void);
+void OS_TaskTimerAdvance(uint32_t elapsed_time);
 void OS_TaskExecution(void);
+bool OS_TaskExecutionBounded(uint8_t max_tasks, uint32_t max_time);
+#if OS_CONFIG_SCHEDULERS > OS_CONFIG_CORES
+OS_feedback OS_SchedulerInit(uint8_t sched);
+OS_feedback OS_SchedulerSelect(uint8_t sched);
+uint8_t OS_GetScheduler(void);
+void OS_SchedulerTimer(uint8_t sched);
+void OS_SchedulerTimerAdvance(uint8_t sched, uint32_t elapsed_time);
+void OS_SchedulerExecution(uint8_t sched);
+bool OS_SchedulerExecutionBounded(uint8_t sched, uint8_t max_tasks, uint32_t max_time);
+#endif
 uint32_t OS_GetOsTime(void);
+uint32_t OS_GetNextDeadline(void);
+#if OS_CONFIG_TICKLESS
+void OS_SetAlarmHook(OS_alarmHook hook);
+#endif
+void OS_SetIdleHook(OS_idleHook hook);
 OS_state OS_GetTaskState(fncPtr function);
 uint32_t OS_GetTaskPeriod(fncPtr function);
 uint32_t OS_GetTaskExecuteTime(fncPtr function);
 OS_feedback OS_SetTaskState(fncPtr function, OS_state new_state);
 OS_feedback OS_SetTaskPeriod(fncPtr function, uint32_t new_task_period);
 OS_feedback OS_SetTaskExecuteTime(fncPtr function, uint32_t new_execute_time);
+bool OS_HandleIsValid(OS_handle handle);
+OS_state OS_HandleGetState(OS_handle handle);
+uint32_t OS_HandleGetPeriod(OS_handle handle);
+uint32_t OS_HandleGetExecuteTime(OS_handle handle);
+OS_feedback OS_HandleSetState(OS_handle handle, OS_state new_state);
+OS_feedback OS_HandleSetPeriod(OS_handle handle, uint32_t new_task_period);
+OS_feedback OS_HandleSetExecuteTime(OS_handle handle, uint32_t new_execute_time);
+uint8_t OS_HandleGetPriority(OS_handle handle);
+OS_feedback OS_HandleSetPriority(OS_handle handle, uint8_t new_priority);
+OS_feedback OS_TaskPostFromISR(OS_handle handle);
+#if OS_CONFIG_EDF
+OS_feedback OS_HandleSetWcet(OS_handle handle, uint32_t wcet_us);
+uint32_t OS_GetUtilisation(void);
+#endif
+#if OS_CONFIG_CHAINS
+OS_feedback OS_HandleChain(OS_handle from, OS_handle to);
+OS_feedback OS_HandleUnchain(OS_handle from, OS_handle to);
+#endif
+#if OS_CONFIG_TASK_GROUPS
+OS_feedback OS_HandleSetGroups(OS_handle handle, uint32_t groups);
+uint32_t OS_HandleGetGroups(OS_handle handle);
+OS_feedback OS_GroupSuspend(uint32_t groups);
+OS_feedback OS_GroupResume(uint32_t groups);
+OS_feedback OS_GroupSetScale(uint32_t groups, uint16_t factor);
+#endif
+void OS_EventInit(OS_event *event, OS_handle task);
+OS_feedback OS_EventSet(OS_event *event, uint32_t flags);
+uint32_t OS_EventTake(OS_event *event, uint32_t mask);
+void OS_QueueInit(OS_queue *queue, void *buffer, uint16_t item_size, uint16_t count, OS_handle task);
+void *OS_QueueAlloc(OS_queue *queue);
+OS_feedback OS_QueueCommit(OS_queue *queue);
+void *OS_QueuePeek(OS_queue *queue);
+void OS_QueueRelease(OS_queue *queue);
+uint16_t OS_QueueCount(const OS_queue *queue);
+OS_feedback OS_HandleSetOverrunPolicy(OS_handle handle, OS_overrun policy, uint8_t burst_limit);
+void OS_SetDeadlineMissHook(OS_deadlineHook hook);
+void OS_SetTimestampHook(OS_timestampHook hook);
+#if OS_CONFIG_SOFT_TIMERS
+void OS_TimerInit(OS_timer *timer, OS_timerCallback callback, void *context);
+OS_feedback OS_TimerStart(OS_timer *timer, uint32_t ticks);
+OS_feedback OS_TimerCancel(OS_timer *timer);
+bool OS_TimerIsActive(const OS_timer *timer);
+#endif
+#if OS_CONFIG_BUDGET
+OS_feedback OS_HandleSetBudget(OS_handle handle, uint32_t budget, OS_budget_action action);
+void OS_SetBudgetHook(OS_budgetHook hook);
+void OS_SetWatchdogHook(OS_watchdogHook hook, uint32_t budget);
+#endif
+#if OS_CONFIG_TRACE
+void OS_TracePause(bool pause);
+uint32_t OS_TraceRead(uint32_t *records, uint32_t max_count);
+#endif
+#if OS_CONFIG_SNAPSHOT
+OS_feedback OS_SnapshotRead(uint8_t sched, OS_snapshot *snapshot);
+#endif
+#if OS_CONFIG_PROFILING
+void OS_ResetStats(void);
+OS_feedback OS_GetTaskStats(fncPtr function, OS_task_stats *stats);
+OS_feedback OS_HandleGetStats(OS_handle handle, OS_task_stats *stats);
+void OS_GetSchedStats(OS_sched_stats *stats);
+#endif
 
 #endif /* OS_H_ */
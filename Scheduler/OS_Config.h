@@ -0,0 +1,243 @@
+/**
+ * @file    OS_Config.h
+ * @brief   Compile time configuration of the task scheduler.
+ *          Every option has a default value here and can be overridden from the compiler command line (-D...),
+ *          so the same scheduler sources can be used for different products.
+ *
+ *          Copyright (c) 2025 github.com/eardali
+ */
+
+#ifndef OS_CONFIG_H_
+#define OS_CONFIG_H_
+
+/**
+ * Maximal number of tasks registered at run time (1..4094), RAM of the scheduler grows with it. Not used with a static task table.
+ * Task positions are 8 bit up to 254 tasks, 16 bit above.
+ */
+#ifndef OS_CONFIG_MAX_TASKS
+#define OS_CONFIG_MAX_TASKS         25
+#endif
+
+/**
+ * Task storage supplied by the application, used if OS_CONFIG_STATIC_TASKS = 0.
+ * 0: storage of OS_CONFIG_MAX_TASKS tasks is reserved in the scheduler.
+ * 1: OS_CONFIG_MAX_TASKS only limits the task positions, storage (OS_task_slot) is added at run time by OS_TaskArenaAdd() in blocks
+ *    of OS_CONFIG_ARENA_BLOCK positions, e.g. from a static array sized for the product, and by the arena hook when the positions
+ *    with storage are used up (see OS_SetArenaHook()). Tasks are accessed through a table of blocks, one more load per access.
+ */
+#ifndef OS_CONFIG_TASK_ARENA
+#define OS_CONFIG_TASK_ARENA        0
+#endif
+
+/**
+ * Number of task positions of an arena block, a power of two, used if OS_CONFIG_TASK_ARENA = 1.
+ */
+#ifndef OS_CONFIG_ARENA_BLOCK
+#define OS_CONFIG_ARENA_BLOCK       8
+#endif
+
+/**
+ * Tick period of the os time in microseconds, it SHALL divide 1000 and be at least 10 (e.g. 100, 250, 1000).
+ * Task periods, defer times and the os time are counted in ticks, see OS_TICKS_US()/OS_TICKS_MS() and the task_period values.
+ */
+#ifndef OS_CONFIG_TICK_US
+#define OS_CONFIG_TICK_US           1000
+#endif
+
+/**
+ * Tickless timer mode.
+ * 0: OS_TaskTimer() SHALL be called from a periodic interrupt (SysTick) every OS_CONFIG_TICK_US.
+ * 1: the scheduler reports its next deadline through the alarm hook (see OS_SetAlarmHook()), the user programs a
+ *    one-shot compare for it and calls OS_TaskTimerAdvance() with the elapsed time on wake-up.
+ */
+#ifndef OS_CONFIG_TICKLESS
+#define OS_CONFIG_TICKLESS          0
+#endif
+
+/**
+ * Number of task priority levels (1..32), priority 0 is the lowest.
+ * 1: READY tasks are executed in task position order.
+ * >1: OS_TaskExecution() always executes the highest priority READY task next, due tasks are released before each pick.
+ */
+#ifndef OS_CONFIG_PRIORITY_LEVELS
+#define OS_CONFIG_PRIORITY_LEVELS   1
+#endif
+
+/**
+ * Earliest deadline first dispatch, used with OS_CONFIG_PRIORITY_LEVELS = 1.
+ * 0: READY tasks are executed in priority and position order.
+ * 1: the READY task with the earliest deadline (end of its period, i.e. its next release) is executed next, READY tasks are kept
+ *    in a heap and due tasks are released after each task. See OS_HandleSetWcet() for the utilisation based admission check.
+ */
+#ifndef OS_CONFIG_EDF
+#define OS_CONFIG_EDF               0
+#endif
+
+/**
+ * Sleep when idle.
+ * 0: OS_TaskExecution() returns right away when no task is READY (unless an idle hook is registered).
+ * 1: OS_TaskExecution() executes WFI when no task is READY and no idle hook is registered (see OS_SetIdleHook()).
+ */
+#ifndef OS_CONFIG_IDLE_WFI
+#define OS_CONFIG_IDLE_WFI          0
+#endif
+
+/**
+ * Fixed rate releases and timed tasks.
+ * 0: a period returned by a task which differs from its stored period starts from the end of the execution.
+ * 1: a changed period starts from the release time of the activation, so the schedule does not drift by execution time and
+ *    dispatch latency. Tasks registered by OS_TaskCreateTimed() receive the release time and lateness of their activation.
+ */
+#ifndef OS_CONFIG_FIXED_RATE
+#define OS_CONFIG_FIXED_RATE        0
+#endif
+
+/**
+ * Execution time profiling and scheduler statistics (see OS_HandleGetStats(), OS_GetSchedStats()).
+ * Timestamps are taken from the DWT cycle counter on Cortex-M3 and above, or from the hook set by OS_SetTimestampHook().
+ * 0: no instrumentation is compiled in.
+ */
+#ifndef OS_CONFIG_PROFILING
+#define OS_CONFIG_PROFILING         0
+#endif
+
+/**
+ * Execution time budgets and watchdog feeding (see OS_HandleSetBudget(), OS_SetWatchdogHook()).
+ * Uses the same timestamp source as profiling.
+ * 0: no budget check is compiled in.
+ */
+#ifndef OS_CONFIG_BUDGET
+#define OS_CONFIG_BUDGET            0
+#endif
+
+/**
+ * Width of period and next execution time stored per task, 16 or 32 bits.
+ * 32: periods and defer times up to 24h (less with ticks shorter than 100us, see OS_MAX_TIME).
+ * 16: saves 4 bytes RAM per task, periods and defer times are limited to 16383 ticks (OS_MAX_TIME) and the main loop SHALL NOT
+ *     fall behind the os time by more than that. The os time itself stays 32 bits.
+ */
+#ifndef OS_CONFIG_TIME_BITS
+#define OS_CONFIG_TIME_BITS         32
+#endif
+
+/**
+ * Task dependency chains (see OS_HandleChain()), a task is put into READY state when all its predecessors are completed.
+ * 0: no chain is compiled in, saves 3 words RAM per task for each 32 tasks.
+ */
+#ifndef OS_CONFIG_CHAINS
+#define OS_CONFIG_CHAINS            0
+#endif
+
+/**
+ * Number of task groups (0..32), a task is a member of any of them (see OS_HandleSetGroups()), a group is suspended, resumed and
+ * slowed down as a whole without looking up its members (see OS_GroupSuspend(), OS_GroupSetScale()), e.g. for power mode changes.
+ * Suspend and resume walk the READY and parked bitmaps, a suspended BLOCKED member still costs one wake-up when it is released.
+ * 0: no group is compiled in.
+ */
+#ifndef OS_CONFIG_TASK_GROUPS
+#define OS_CONFIG_TASK_GROUPS       0
+#endif
+
+/**
+ * Software timers (see OS_TimerStart()), one-shot callbacks kept in a timing wheel per core, started and cancelled in O(1).
+ * 0: no timer is compiled in.
+ */
+#ifndef OS_CONFIG_SOFT_TIMERS
+#define OS_CONFIG_SOFT_TIMERS       0
+#endif
+
+/**
+ * Number of slots of the timing wheel, a power of two, used if OS_CONFIG_SOFT_TIMERS = 1.
+ * Timers expiring within this many ticks share a slot only if they expire on the same tick, later ones are skipped once per turn.
+ */
+#ifndef OS_CONFIG_TIMER_WHEEL_SIZE
+#define OS_CONFIG_TIMER_WHEEL_SIZE  64
+#endif
+
+/**
+ * Trace of scheduler events into a RAM ring buffer per core (see OS_TraceRead(), tools/os_trace.py).
+ * Events are 4 byte records with a timestamp delta, taken from the same timestamp source as profiling.
+ * 0: no trace is compiled in.
+ */
+#ifndef OS_CONFIG_TRACE
+#define OS_CONFIG_TRACE             0
+#endif
+
+/**
+ * Number of records in the trace buffer of a core, used if OS_CONFIG_TRACE = 1.
+ */
+#ifndef OS_CONFIG_TRACE_SIZE
+#define OS_CONFIG_TRACE_SIZE        256
+#endif
+
+/**
+ * Snapshot mirror of the tasks (see OS_SnapshotRead()), number of task records in the mirror of every scheduler instance.
+ * The mirror is refreshed by OS_TaskExecution() under a sequence lock and can be read by interrupt handlers, other cores or
+ * a debug probe (symbol os_snapshot) without stopping the scheduler. Live tasks above this number are counted but not recorded.
+ * 0: no snapshot is compiled in.
+ */
+#ifndef OS_CONFIG_SNAPSHOT
+#define OS_CONFIG_SNAPSHOT          0
+#endif
+
+/**
+ * Minimal number of ticks between two refreshes of the snapshot mirror by OS_TaskExecution(), 0 to refresh every pass.
+ */
+#ifndef OS_CONFIG_SNAPSHOT_PERIOD
+#define OS_CONFIG_SNAPSHOT_PERIOD   100
+#endif
+
+/**
+ * Attributes of the snapshot mirror, e.g. __attribute__((section(".debug_mirror"))) to place it at an address known to the debug
+ * probe. The section SHALL be zero initialised.
+ */
+#ifndef OS_CONFIG_SNAPSHOT_ATTRIBUTE
+#define OS_CONFIG_SNAPSHOT_ATTRIBUTE
+#endif
+
+/**
+ * Number of cores running an OS_TaskExecution() loop (1..16).
+ * >1: every core has its own scheduler (task list, os time, hooks), the functions act on the scheduler of the calling core.
+ *     Core index is read by OS_PORT_CORE_ID() (RP2040 SIO CPUID by default), see OS_Port.h.
+ */
+#ifndef OS_CONFIG_CORES
+#define OS_CONFIG_CORES             1
+#endif
+
+/**
+ * Number of pending requests from one core to another (see OS_TaskCreateOnCore(), OS_HandleMigrate()), used if OS_CONFIG_CORES > 1.
+ */
+#ifndef OS_CONFIG_MAILBOX_SIZE
+#define OS_CONFIG_MAILBOX_SIZE      4
+#endif
+
+/**
+ * Number of scheduler instances (OS_CONFIG_CORES..16), every instance has its own task list, os time, timers and hooks.
+ * Instances 0..OS_CONFIG_CORES-1 are the schedulers of the cores. Further instances are bound to a core by OS_SchedulerInit(),
+ * ticked by their own timer and executed by their own call in the infinite loop (see OS_SchedulerTimer(), OS_SchedulerExecution()),
+ * e.g. a control scheduler ticked every 100us next to the 1ms scheduler of the core, neither visits the tasks of the other.
+ * Periods and defer times of an instance count in its own ticks.
+ */
+#ifndef OS_CONFIG_SCHEDULERS
+#define OS_CONFIG_SCHEDULERS        OS_CONFIG_CORES
+#endif
+
+/**
+ * Static task table.
+ * 0: tasks are registered at run time by OS_TaskCreate()/OS_TaskCreateInstance().
+ * 1: the task set is fixed at build time in the header named by OS_CONFIG_TASK_TABLE, creation functions are not compiled in.
+ *    Function, data and default values of the tasks are kept in flash, only the run time part of the tasks is kept in RAM.
+ */
+#ifndef OS_CONFIG_STATIC_TASKS
+#define OS_CONFIG_STATIC_TASKS      0
+#endif
+
+/**
+ * Header of the static task table, it SHALL define OS_TASK_TABLE(X) with one X(name, function, period, state, data_ptr, defer_time)
+ * entry per task (e.g. X(led, LED_Task, period_100ms, BLOCKED, NULL, 0)) and declare the functions and data used there.
+ */
+#ifndef OS_CONFIG_TASK_TABLE
+#define OS_CONFIG_TASK_TABLE        "OS_TaskTable.h"
+#endif
+
+#endif /* OS_CONFIG_H_ */
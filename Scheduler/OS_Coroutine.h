@@ -0,0 +1,68 @@
+/**
+ * @file    OS_Coroutine.h
+ * @brief   Stackless coroutine tasks (protothread style) on top of the task scheduler.
+ *          A coroutine is an ordinary task function, each wait primitive saves its resume point and returns the time to
+ *          the scheduler as the next period, the next execution continues right after the primitive.
+ *          So long jobs (flash writes, sensor init sequences) can be sliced without blocking the main loop or a stack per task.
+ *
+ *          Rules of the body between OS_CO_BEGIN() and OS_CO_END():
+ *          - local variables are not kept over a wait, keep them in the data of the task (or static),
+ *          - no switch statement, the resume points are case labels of a switch,
+ *          - at most one wait primitive per source line.
+ *
+ *          Copyright (c) 2025 github.com/eardali
+ */
+
+#ifndef OS_COROUTINE_H_
+#define OS_COROUTINE_H_
+
+#include "OS.h"
+
+/**
+ * Resume point of a coroutine, put it into the data of the task. All zero is the start of the body.
+ */
+typedef struct
+{
+    uint16_t resume;                    /**< source line of the last wait, 0 before the first one */
+} OS_coroutine;
+
+#define OS_CO_INIT(co)          ((co)->resume = 0u)         /**< Restart the coroutine from the beginning at its next execution. */
+
+/**
+ * Starts the body of a coroutine, continues at the saved resume point.
+ */
+#define OS_CO_BEGIN(co)         switch((co)->resume){ case 0u:
+
+/**
+ * Saves the resume point and returns given period to the scheduler, used by the primitives below.
+ */
+#define OS_CO_RETURN(co, period) \
+    do{ (co)->resume = (uint16_t)__LINE__; return (uint32_t)(period); case __LINE__:; }while(0)
+
+/**
+ * Gives the main loop to the other tasks, continues at the next tick.
+ */
+#define OS_CO_YIELD(co)         OS_CO_RETURN(co, OS_MIN_TIME)
+
+/**
+ * Continues after given ticks (1..OS_MAX_TIME), e.g. OS_CO_DELAY(co, OS_TICKS_MS(5)).
+ */
+#define OS_CO_DELAY(co, ticks)  OS_CO_RETURN(co, ticks)
+
+/**
+ * Waits in WAITING state until the task is posted (see OS_TaskPostFromISR()).
+ */
+#define OS_CO_WAIT_EVENT(co)    OS_CO_RETURN(co, period_wait)
+
+/**
+ * Checks cond every poll ticks (1..OS_MAX_TIME), continues when it is true, cond is checked right away first.
+ */
+#define OS_CO_WAIT_UNTIL(co, cond, poll) \
+    do{ if(!(cond)){ (co)->resume = (uint16_t)__LINE__; return (uint32_t)(poll); case __LINE__: if(!(cond)){ return (uint32_t)(poll); } } }while(0)
+
+/**
+ * Ends the body, next execution starts from the beginning after given period (period_end stops the task).
+ */
+#define OS_CO_END(co, period)   } (co)->resume = 0u; return (uint32_t)(period)
+
+#endif /* OS_COROUTINE_H_ */
@@ -0,0 +1,270 @@
+/**
+ * @file    OS_Port.h
+ * @brief   Target specific helpers of the task scheduler.
+ *          Intrinsics are used on GCC/Clang (Cortex-M3 and above map them to single instructions),
+ *          portable C fallbacks are provided for other compilers.
+ *          This file is internal to the scheduler sources.
+ *
+ *          Copyright (c) 2025 github.com/eardali
+ */
+
+#ifndef OS_PORT_H_
+#define OS_PORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "OS_Config.h"
+
+/*
+ * Index of the calling core, several cores run their own scheduler if OS_CONFIG_CORES > 1.
+ * OS_PORT_CORE_ID() may be defined on the command line for other parts.
+ */
+#if OS_CONFIG_CORES > 1
+#ifndef OS_PORT_CORE_ID
+#define OS_PORT_CORE_ID()   (*(volatile uint32_t *)0xD0000000u)         //RP2040 SIO CPUID
+#endif
+static inline uint8_t OS_PortCoreId(void)
+{
+    return (uint8_t)OS_PORT_CORE_ID();
+}
+#else
+static inline uint8_t OS_PortCoreId(void)
+{
+    return 0u;
+}
+#endif
+
+/**
+ * Returns index of the least significant set bit, x SHALL NOT be 0.
+ */
+static inline uint8_t OS_PortCtz(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)__builtin_ctz(x); //RBIT + CLZ on Cortex-M3+
+#else
+    uint8_t n = 0u;
+    while((x & 1u) == 0u){
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Returns number of leading zero bits, x SHALL NOT be 0.
+ */
+static inline uint8_t OS_PortClz(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)__builtin_clz(x); //CLZ on Cortex-M3+
+#else
+    uint8_t n = 0u;
+    while((x & 0x80000000u) == 0u){
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M') && (defined(__GNUC__) || defined(__clang__))
+/**
+ * Masks interrupts and returns previous PRIMASK value.
+ */
+static inline uint32_t OS_PortIrqSave(void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (primask) :: "memory");
+    return primask;
+}
+
+/**
+ * Restores PRIMASK value returned by OS_PortIrqSave().
+ */
+static inline void OS_PortIrqRestore(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+
+/**
+ * Sleeps until an interrupt is pending, wakes up even if interrupts are masked by PRIMASK.
+ */
+static inline void OS_PortWaitForInterrupt(void)
+{
+    __asm volatile ("dsb\n wfi" ::: "memory");
+}
+
+/**
+ * Sleeps until an event from another core (SEV) or a pending interrupt, SEVONPEND makes masked interrupts wake up too.
+ */
+static inline void OS_PortWaitForEvent(void)
+{
+    *(volatile uint32_t *)0xE000ED10u |= (1u << 4);    //SCB.SCR.SEVONPEND
+    __asm volatile ("dsb\n wfe" ::: "memory");
+}
+
+/**
+ * Wakes up other cores sleeping in OS_PortWaitForEvent().
+ */
+static inline void OS_PortSignalEvent(void)
+{
+    __asm volatile ("dsb\n sev" ::: "memory");
+}
+#else
+/* Host build or unknown core, interrupts are not masked and sleep returns right away. */
+static inline uint32_t OS_PortIrqSave(void)
+{
+    return 0u;
+}
+
+static inline void OS_PortIrqRestore(uint32_t primask)
+{
+    (void)primask;
+}
+
+static inline void OS_PortWaitForInterrupt(void)
+{
+}
+
+static inline void OS_PortWaitForEvent(void)
+{
+}
+
+static inline void OS_PortSignalEvent(void)
+{
+}
+#endif
+
+/**
+ * Returns true if called from an interrupt handler (IPSR holds the active exception number).
+ */
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M') && (defined(__GNUC__) || defined(__clang__))
+static inline bool OS_PortInIsr(void)
+{
+    uint32_t ipsr;
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr != 0u;
+}
+#else
+static inline bool OS_PortInIsr(void)
+{
+    return false;
+}
+#endif
+
+/*
+ * Atomic read-modify-write of a 32 bit word shared between interrupts, main loop and other cores.
+ * LDREX/STREX loops are used on Cortex-M3 and above, ARMv6-M (Cortex-M0/M0+) has no exclusive access, interrupts are masked
+ * for the few instructions there, and a hardware spinlock is taken on multi-core parts.
+ */
+#if OS_CONFIG_CORES > 1
+#ifndef OS_PORT_SPINLOCK_ACQUIRE
+#define OS_PORT_SPINLOCK_ACQUIRE()  while(*(volatile uint32_t *)0xD000017Cu == 0u){}   //RP2040 SIO spinlock 31, read claims it
+#define OS_PORT_SPINLOCK_RELEASE()  (*(volatile uint32_t *)0xD000017Cu = 1u)            //write releases it
+#endif
+#else
+#define OS_PORT_SPINLOCK_ACQUIRE()
+#define OS_PORT_SPINLOCK_RELEASE()
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__ARM_ARCH_6M__)
+static inline void OS_PortAtomicOr(volatile uint32_t *word, uint32_t bits)
+{
+    (void)__atomic_fetch_or(word, bits, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t OS_PortAtomicExchange(volatile uint32_t *word, uint32_t value)
+{
+    return __atomic_exchange_n(word, value, __ATOMIC_SEQ_CST);
+}
+
+static inline void OS_PortAtomicAdd(volatile uint32_t *word, uint32_t value)
+{
+    (void)__atomic_fetch_add(word, value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t OS_PortAtomicFetchAnd(volatile uint32_t *word, uint32_t bits)
+{
+    return __atomic_fetch_and(word, bits, __ATOMIC_SEQ_CST);
+}
+#else
+static inline void OS_PortAtomicOr(volatile uint32_t *word, uint32_t bits)
+{
+    uint32_t primask = OS_PortIrqSave();
+    OS_PORT_SPINLOCK_ACQUIRE();
+    *word |= bits;
+    OS_PORT_SPINLOCK_RELEASE();
+    OS_PortIrqRestore(primask);
+}
+
+static inline uint32_t OS_PortAtomicExchange(volatile uint32_t *word, uint32_t value)
+{
+    uint32_t primask = OS_PortIrqSave();
+    OS_PORT_SPINLOCK_ACQUIRE();
+    uint32_t old = *word;
+    *word = value;
+    OS_PORT_SPINLOCK_RELEASE();
+    OS_PortIrqRestore(primask);
+    return old;
+}
+
+static inline void OS_PortAtomicAdd(volatile uint32_t *word, uint32_t value)
+{
+    uint32_t primask = OS_PortIrqSave();
+    OS_PORT_SPINLOCK_ACQUIRE();
+    *word += value;
+    OS_PORT_SPINLOCK_RELEASE();
+    OS_PortIrqRestore(primask);
+}
+
+static inline uint32_t OS_PortAtomicFetchAnd(volatile uint32_t *word, uint32_t bits)
+{
+    uint32_t primask = OS_PortIrqSave();
+    OS_PORT_SPINLOCK_ACQUIRE();
+    uint32_t old = *word;
+    *word = old & bits;
+    OS_PORT_SPINLOCK_RELEASE();
+    OS_PortIrqRestore(primask);
+    return old;
+}
+#endif
+
+/**
+ * Orders memory accesses, a word written before is visible to other cores before the words written after.
+ */
+static inline void OS_PortMemoryBarrier(void)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST); //DMB on Cortex-M
+#endif
+}
+
+/*
+ * DWT cycle counter, available on ARMv7-M (Cortex-M3/M4/M7) and ARMv8-M mainline (Cortex-M33).
+ * Other cores return 0, a timestamp hook shall be used there.
+ */
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+static inline void OS_PortCycleCounterInit(void)
+{
+    *(volatile uint32_t *)0xE000EDFCu |= (1u << 24);    //DEMCR.TRCENA, enable DWT
+    *(volatile uint32_t *)0xE0001FB0u = 0xC5ACCE55u;    //DWT.LAR, unlock on Cortex-M7
+    *(volatile uint32_t *)0xE0001000u |= 1u;            //DWT.CTRL.CYCCNTENA
+}
+
+static inline uint32_t OS_PortCycleCounter(void)
+{
+    return *(volatile uint32_t *)0xE0001004u;           //DWT.CYCCNT
+}
+#else
+static inline void OS_PortCycleCounterInit(void)
+{
+}
+
+static inline uint32_t OS_PortCycleCounter(void)
+{
+    return 0u;
+}
+#endif
+
+#endif /* OS_PORT_H_ */
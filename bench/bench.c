@@ -0,0 +1,107 @@
+/**
+ * @file    bench.c
+ * @brief   Host benchmark of the scheduler core, driven by a simulated clock.
+ *          OS_CONFIG_MAX_TASKS tasks are registered, then the os time advances one tick per OS_TaskTimer() call
+ *          followed by OS_TaskExecution(). Timestamps are clock_gettime() nanoseconds through the timestamp hook, so tick and
+ *          dispatch costs are those of OS_GetSchedStats(), create and find costs are timed around the calls.
+ *
+ *          bench <ticks> <churn> <mix>
+ *          churn: tasks stopped and created again per 1000 ticks
+ *          mix:   harmonic (1, 2, 5, 10, 20, 50, 100 ticks) or mixed (1..97 ticks, mostly co-prime)
+ *
+ *          Copyright (c) 2025 github.com/eardali
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "OS.h"
+
+#define BENCH_FIND_LOOPS    1000u   /**< Calls timed for the find cost. */
+
+static const uint32_t harmonic[] = {1u, 2u, 5u, 10u, 20u, 50u, 100u};
+static OS_handle handles[OS_CONFIG_MAX_TASKS];
+static bool mixed;
+
+static uint32_t BENCH_Now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)((uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec);
+}
+
+/**
+ * Task of the benchmark, a short piece of work keeps its period
+ */
+static uint32_t BENCH_Task(void *data)
+{
+    volatile uint32_t work = 0u;
+    for(uint32_t i = 0u; i < 16u; i++){
+        work += i;
+    }
+    return (uint32_t)(uintptr_t)data;
+}
+
+/**
+ * Task never registered, looked up to time a search over every task
+ */
+static uint32_t BENCH_Missing(void *data)
+{
+    (void)data;
+    return period_end;
+}
+
+static uint32_t BENCH_Period(uint32_t i)
+{
+    return mixed ? (1u + ((i * 37u) % 97u)) : harmonic[i % (sizeof(harmonic) / sizeof(harmonic[0]))];
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t ticks = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100000u;
+    uint32_t churn = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0u;
+    uint64_t create_total = 0u;
+    uint32_t create_count = 0u;
+    uint32_t stamp;
+    OS_sched_stats stats;
+    mixed = (argc > 3) && (strcmp(argv[3], "mixed") == 0);
+    OS_SetTimestampHook(BENCH_Now);
+
+    for(uint32_t i = 0u; i < OS_CONFIG_MAX_TASKS; i++){
+        uint32_t period = BENCH_Period(i);
+        stamp = BENCH_Now();
+        OS_TaskCreateInstance(BENCH_Task, period, BLOCKED, (void *)(uintptr_t)period, i % period, &handles[i]);
+        create_total += BENCH_Now() - stamp;
+        create_count++;
+    }
+
+    stamp = BENCH_Now();
+    for(uint32_t i = 0u; i < BENCH_FIND_LOOPS; i++){
+        (void)OS_TaskIsInQueue(BENCH_Missing);
+    }
+    uint32_t find = (BENCH_Now() - stamp) / BENCH_FIND_LOOPS;
+
+    OS_ResetStats();
+    for(uint32_t tick = 0u; tick < ticks; tick++){
+        if((churn != 0u) && ((tick % (1000u / ((churn < 1000u) ? churn : 1000u))) == 0u)){ //stop a task and create it again
+            uint32_t i = (tick / 7u) % OS_CONFIG_MAX_TASKS;
+            uint32_t period = BENCH_Period(i);
+            OS_HandleSetState(handles[i], STOPPED);
+            stamp = BENCH_Now();
+            OS_TaskCreateInstance(BENCH_Task, period, BLOCKED, (void *)(uintptr_t)period, 1u + (tick % period), &handles[i]);
+            create_total += BENCH_Now() - stamp;
+            create_count++;
+        }
+        OS_TaskTimer();
+        OS_TaskExecution();
+    }
+    OS_GetSchedStats(&stats);
+
+    printf("tasks %4u  mix %-8s churn %4u  tick avg %5u max %6u  dispatch avg %6u max %7u  create avg %6u  find %6u  activations %u (ns)\n",
+           (unsigned)OS_CONFIG_MAX_TASKS, mixed ? "mixed" : "harmonic", churn, stats.tick_isr_avg, stats.tick_isr_max,
+           stats.dispatch_avg, stats.dispatch_max, (uint32_t)(create_total / create_count), find, stats.activations);
+    return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file    check.c
+ * @brief   Host regression check of the scheduler core, driven by a simulated clock.
+ *          Random tasks are created, change their periods, stop and are stopped from outside while the os time advances
+ *          one tick per pass, some of them posted right before the stop. A model of every task predicts its next release,
+ *          each execution is checked against it, so ordering of the deadline heap, os time wrap and handle reuse are covered.
+ *
+ *          check <seed> [base]    base is the os time at start, e.g. 0xFFFFF000 to run across the wrap
+ *
+ *          Copyright (c) 2025 github.com/eardali
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "OS.h"
+
+#define CHECK_TICKS     20000u      /**< Simulated ticks of a run. */
+#define CHECK_PERIOD    50u         /**< Maximal period of a task. */
+#define CHECK_DEFER     60u         /**< Maximal defer time of a task. */
+
+/**
+ * Model of a task.
+ */
+typedef struct
+{
+    OS_handle   handle;             /**< Handle of the task, stale once it is stopped. */
+    uint32_t    next;               /**< Expected os time of the next execution. */
+    bool        alive;              /**< Task is registered. */
+} check_task;
+
+static check_task  model[OS_CONFIG_MAX_TASKS];
+static OS_handle   stale[OS_CONFIG_MAX_TASKS];     /**< Handles of stopped tasks, checked to stay stale. */
+static uint32_t    stale_count;
+static uint32_t    executions;
+static uint32_t    last_position;                  /**< Position of the previous task executed in the pass, plus 1. */
+static int         failures;
+
+#if OS_CONFIG_TASK_ARENA
+#define CHECK_SLOTS     (((OS_CONFIG_MAX_TASKS + OS_CONFIG_ARENA_BLOCK - 1) / OS_CONFIG_ARENA_BLOCK) * OS_CONFIG_ARENA_BLOCK) /**< Whole blocks for every position. */
+static OS_task_slot slots[CHECK_SLOTS];
+#endif
+
+static void CHECK_Fail(const char *what, uint32_t slot)
+{
+    if(failures++ < 10){
+        printf("FAIL %s: slot %u at os time %u\n", what, slot, OS_GetOsTime());
+    }
+}
+
+static void CHECK_Stale(OS_handle handle)
+{
+    stale[stale_count++ % OS_CONFIG_MAX_TASKS] = handle;
+}
+
+/**
+ * Task of the check, compares its execution with the model and picks its next period
+ */
+static uint32_t CHECK_Task(void *data)
+{
+    uint32_t slot = (uint32_t)(uintptr_t)data;
+    uint32_t now = OS_GetOsTime();
+    uint32_t position = model[slot].handle & 0x0FFFu;
+    uint32_t r = (uint32_t)rand() % 100u;
+    executions++;
+    if(!model[slot].alive || (model[slot].next != now)){
+        CHECK_Fail("executed out of time", slot);
+    }
+#if (OS_CONFIG_PRIORITY_LEVELS == 1) && !OS_CONFIG_EDF
+    if(position + 1u <= last_position){ //READY tasks of a pass are executed in position order
+        CHECK_Fail("executed out of order", slot);
+    }
+#endif
+    last_position = position + 1u;
+    if(r < 5u){ //last execution
+        model[slot].alive = false;
+        CHECK_Stale(model[slot].handle);
+        return period_end;
+    }else if(r < 25u){ //new period
+        uint32_t period = 1u + ((uint32_t)rand() % CHECK_PERIOD);
+        model[slot].next = now + period;
+        return period;
+    }else{
+        uint32_t period = OS_HandleGetPeriod(model[slot].handle);
+        model[slot].next = now + period;
+        return period;
+    }
+}
+
+/**
+ * Random changes of the task set from the main loop, before the tick
+ */
+static void CHECK_Churn(void)
+{
+    uint32_t slot = (uint32_t)rand() % OS_CONFIG_MAX_TASKS;
+    uint32_t r = (uint32_t)rand() % 100u;
+    if(!model[slot].alive && (r < 40u)){
+        uint32_t period = 1u + ((uint32_t)rand() % CHECK_PERIOD);
+        uint32_t defer = 1u + ((uint32_t)rand() % CHECK_DEFER);
+        if(OS_TaskCreateInstance(CHECK_Task, period, BLOCKED, (void *)(uintptr_t)slot, defer, &model[slot].handle) != OK){
+            CHECK_Fail("create", slot);
+        }else{
+            model[slot].alive = true;
+            model[slot].next = OS_GetOsTime() + defer;
+        }
+    }else if(model[slot].alive && (r < 10u)){
+        if((r < 5u) && (OS_TaskPostFromISR(model[slot].handle) != OK)){ //post left pending by the stop
+            CHECK_Fail("post", slot);
+        }
+        if(OS_HandleSetState(model[slot].handle, STOPPED) != OK){
+            CHECK_Fail("stop", slot);
+        }
+        model[slot].alive = false;
+        CHECK_Stale(model[slot].handle);
+    }
+}
+
+/**
+ * Compare the scheduler with the model after a pass
+ */
+static void CHECK_Compare(void)
+{
+    uint32_t now = OS_GetOsTime();
+    uint32_t next = now + OS_MAX_TIME;
+    uint32_t live = 0u;
+    for(uint32_t slot = 0u; slot < OS_CONFIG_MAX_TASKS; slot++){
+        if(model[slot].alive){
+            live++;
+            if(OS_TIME_DIFF(model[slot].next, now) <= 0){
+                CHECK_Fail("not executed when due", slot);
+            }else if(OS_TIME_DIFF(model[slot].next, next) < 0){
+                next = model[slot].next;
+            }
+            if(OS_HandleGetState(model[slot].handle) != BLOCKED){
+                CHECK_Fail("not BLOCKED", slot);
+            }
+        }
+    }
+    if(OS_GetNextDeadline() != next){
+        CHECK_Fail("next deadline", live);
+    }
+    for(uint32_t i = 0u; (i < stale_count) && (i < OS_CONFIG_MAX_TASKS); i++){
+        if(OS_HandleSetState(stale[i], BLOCKED) != NOK_INVALID_HANDLE){
+            CHECK_Fail("stale handle accepted", i);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = (argc > 1) ? (unsigned)strtoul(argv[1], NULL, 0) : 1u;
+    uint32_t base = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0u;
+    srand(seed);
+#if OS_CONFIG_TASK_ARENA
+    OS_TaskArenaAdd(slots, CHECK_SLOTS);
+#endif
+    OS_TaskTimerAdvance(base);
+    for(uint32_t tick = 0u; tick < CHECK_TICKS; tick++){
+        for(uint32_t k = (uint32_t)rand() % 4u; k > 0u; k--){
+            CHECK_Churn();
+        }
+        OS_TaskTimer();
+        last_position = 0u;
+        OS_TaskExecution();
+        CHECK_Compare();
+    }
+    printf("%s seed %u base 0x%08X: %u executions, %d failures\n", (failures == 0) ? "ok" : "FAIL", seed, base, executions, failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""
+Converts a scheduler trace (records read by OS_TraceRead(), see OS_CONFIG_TRACE) to Chrome trace JSON,
+which can be opened by chrome://tracing or https://ui.perfetto.dev.
+
+Input is the raw record dump, 32 bit little endian words (e.g. written to a file by the target or dumped by a debugger).
+Task executions become duration slices on one track per task, releases, posts, creations, stops, idle passes and
+lost records become instant events.
+
+    os_trace.py trace.bin --clock 72000000 --name 0=led --name 1=uart -o trace.json
+
+Copyright (c) 2025 github.com/eardali
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+# Must match OS_trace_event in OS.h
+RELEASE, START, END, CREATE, STOP, POST, IDLE, LOST, EXT = range(9)
+INSTANTS = {RELEASE: "release", CREATE: "create", STOP: "stop", POST: "post"}
+
+
+def decode(data):
+    """Yields (time, event, task) with time in timestamp units from the first record."""
+    now = None
+    ext = 0
+    for (record,) in struct.iter_unpack("<I", data[: len(data) // 4 * 4]):
+        event = record & 0x0F
+        if event == EXT:
+            ext = (record >> 4) << 20
+            continue
+        delta = ext | (record >> 12)
+        ext = 0
+        now = 0 if now is None else now + delta  # delta of the first record refers to a record not read
+        yield now, event, (record >> 4) & 0xFF
+
+
+def convert(data, clock, names, pid):
+    scale = 1e6 / clock  # Chrome trace times are microseconds
+    events = []
+    running = {}
+
+    def task_name(task):
+        return names.get(task, "task %d" % task)
+
+    for task, name in names.items():
+        events.append({"ph": "M", "name": "thread_name", "pid": pid, "tid": task, "args": {"name": name}})
+    for now, event, task in decode(data):
+        ts = now * scale
+        if event == START:
+            running[task] = ts
+            events.append({"ph": "B", "name": task_name(task), "pid": pid, "tid": task, "ts": ts})
+        elif event == END:
+            if running.pop(task, None) is not None:  # start may be lost or read before
+                events.append({"ph": "E", "pid": pid, "tid": task, "ts": ts})
+        elif event in INSTANTS:
+            events.append({"ph": "i", "s": "t", "name": INSTANTS[event], "pid": pid, "tid": task, "ts": ts})
+        elif event == IDLE:
+            events.append({"ph": "i", "s": "p", "name": "idle", "pid": pid, "tid": 0, "ts": ts})
+        elif event == LOST:
+            events.append({"ph": "i", "s": "g", "name": "lost %d records" % task, "pid": pid, "tid": 0, "ts": ts})
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1], formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", help="raw trace records, '-' for stdin")
+    parser.add_argument("-o", "--output", help="output JSON file, stdout if not given")
+    parser.add_argument("--clock", type=float, default=1e6, help="timestamp units per second (e.g. CPU clock for DWT), default 1e6")
+    parser.add_argument("--name", action="append", default=[], metavar="POS=NAME", help="name of the task at a position")
+    parser.add_argument("--core", type=int, default=0, help="core of the trace, used as process id")
+    args = parser.parse_args()
+
+    names = {}
+    for item in args.name:
+        pos, _, name = item.partition("=")
+        names[int(pos)] = name
+    data = sys.stdin.buffer.read() if args.trace == "-" else open(args.trace, "rb").read()
+    result = convert(data, args.clock, names, args.core)
+    if args.output:
+        with open(args.output, "w") as out:
+            json.dump(result, out)
+    else:
+        json.dump(result, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()